@@ -4,6 +4,7 @@
 #include <NAS2D/Renderer/Color.h>
 
 #include <array>
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
@@ -53,7 +54,7 @@ enum class Direction
 /**
  * Terrain type enumeration
  */
-enum class TerrainType
+enum class TerrainType : std::uint8_t
 {
 	Dozed,
 	Clear,
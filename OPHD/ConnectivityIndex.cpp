@@ -0,0 +1,163 @@
+#include "ConnectivityIndex.h"
+
+#include "GraphWalker.h"
+#include "StructureManager.h"
+
+#include "Map/Tile.h"
+#include "Map/TileMap.h"
+#include "States/MapViewStateHelper.h"
+
+#include <NAS2D/Utility.h>
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+
+namespace
+{
+	constexpr std::array Directions{Direction::Up, Direction::Down, Direction::North, Direction::East, Direction::South, Direction::West};
+
+
+	constexpr Direction opposite(Direction direction)
+	{
+		switch (direction)
+		{
+		case Direction::Up: return Direction::Down;
+		case Direction::Down: return Direction::Up;
+		case Direction::East: return Direction::West;
+		case Direction::West: return Direction::East;
+		case Direction::North: return Direction::South;
+		case Direction::South: return Direction::North;
+		}
+
+		throw std::runtime_error("Invalid direction");
+	}
+}
+
+
+ConnectivityIndex::ConnectivityIndex(TileMap& tileMap) :
+	mTileMap{tileMap}
+{
+	auto& structureManager = NAS2D::Utility<StructureManager>::get();
+	structureManager.structureAdded().connect(this, &ConnectivityIndex::onStructureAdded);
+	structureManager.structureRemoved().connect(this, &ConnectivityIndex::onStructureRemoved);
+}
+
+
+ConnectivityIndex::~ConnectivityIndex()
+{
+	auto& structureManager = NAS2D::Utility<StructureManager>::get();
+	structureManager.structureAdded().disconnect(this, &ConnectivityIndex::onStructureAdded);
+	structureManager.structureRemoved().disconnect(this, &ConnectivityIndex::onStructureRemoved);
+}
+
+
+/**
+ * Brings the index up to date. Does nothing unless a connected structure
+ * was removed or the Command Center has come online since the last update.
+ */
+void ConnectivityIndex::update()
+{
+	auto* root = rootTile();
+	if (mDirty || (root && !root->connected()) || (!root && !mConnectedTiles.empty()))
+	{
+		recompute();
+	}
+
+#ifdef OPHD_CHECK_CONNECTIVITY
+	if (!validate())
+	{
+		throw std::runtime_error("ConnectivityIndex::update(): Incremental connectedness does not match a full recompute.");
+	}
+#endif
+}
+
+
+/**
+ * Rebuilds the index with a full walk from the Command Center.
+ */
+void ConnectivityIndex::recompute()
+{
+	mTileMap.clearConnected();
+	mConnectedTiles.clear();
+	mDirty = false;
+
+	if (auto* root = rootTile())
+	{
+		GraphWalker graphWalker(root->xyz(), mTileMap, mConnectedTiles);
+	}
+}
+
+
+/**
+ * Rebuilds the index and reports whether the rebuilt index matches the one
+ * that was maintained incrementally.
+ */
+bool ConnectivityIndex::validate()
+{
+	auto incremental = mConnectedTiles;
+	recompute();
+	auto recomputed = mConnectedTiles;
+
+	std::sort(incremental.begin(), incremental.end());
+	std::sort(recomputed.begin(), recomputed.end());
+	return incremental == recomputed;
+}
+
+
+/**
+ * Connects a new structure, and anything it links up, if it joins a tile
+ * that is already connected.
+ */
+void ConnectivityIndex::onStructureAdded(Tile& tile)
+{
+	if (mDirty || tile.connected()) { return; }
+
+	auto* root = rootTile();
+	if (!root || !root->connected()) { return; }
+
+	const auto position = tile.xyz();
+	for (const auto direction : Directions)
+	{
+		const auto neighborPosition = position.translate(direction);
+		if (!mTileMap.isValidPosition(neighborPosition)) { continue; }
+
+		if (mTileMap.getTile(neighborPosition).connected() && GraphWalker::canWalk(mTileMap, neighborPosition, opposite(direction)))
+		{
+			GraphWalker graphWalker(position, mTileMap, mConnectedTiles);
+			return;
+		}
+	}
+}
+
+
+void ConnectivityIndex::onStructureRemoved(Tile& tile)
+{
+	if (!tile.connected()) { return; }
+
+	tile.connected(false);
+	mDirty = true;
+}
+
+
+/**
+ * The Command Center's tile, or nullptr if there is no Command Center
+ * able to anchor the network yet.
+ */
+Tile* ConnectivityIndex::rootTile() const
+{
+	if (ccLocation() == CcNotPlaced) { return nullptr; }
+
+	auto& tile = mTileMap.getTile({ccLocation(), 0});
+	auto* cc = tile.structure();
+
+	if (!cc)
+	{
+		throw std::runtime_error("CC coordinates do not actually point to a Command Center.");
+	}
+
+	if (cc->state() == StructureState::UnderConstruction) { return nullptr; }
+
+	return &tile;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Map/MapCoordinate.h"
+
+#include <vector>
+
+
+class Tile;
+class TileMap;
+
+
+/**
+ * Tracks which tiles are connected to the Command Center.
+ *
+ * Each Tile's connected flag is the index, so asking whether a tile is
+ * connected is a single lookup. Placing a structure only walks the tiles
+ * it newly connects. Removing a connected structure can split the network
+ * so it marks the index dirty and the next update() rebuilds it with a
+ * full walk from the Command Center.
+ *
+ * Define OPHD_CHECK_CONNECTIVITY to have every update() also rebuild the
+ * index from scratch and verify the incremental result against it.
+ */
+class ConnectivityIndex
+{
+public:
+	explicit ConnectivityIndex(TileMap& tileMap);
+	~ConnectivityIndex();
+
+	ConnectivityIndex(const ConnectivityIndex&) = delete;
+	ConnectivityIndex& operator=(const ConnectivityIndex&) = delete;
+
+	void update();
+	void recompute();
+	bool validate();
+
+	void invalidate() { mDirty = true; }
+
+	const std::vector<Tile*>& connectedTiles() const { return mConnectedTiles; }
+
+private:
+	void onStructureAdded(Tile& tile);
+	void onStructureRemoved(Tile& tile);
+
+	Tile* rootTile() const;
+
+	TileMap& mTileMap;
+	std::vector<Tile*> mConnectedTiles;
+	bool mDirty{true};
+};
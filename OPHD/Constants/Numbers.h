@@ -48,6 +48,13 @@ namespace constants
 
 	inline constexpr auto MinimumWindowSize{NAS2D::Vector{1000, 700}};
 
+	/**<
+	 * Map size in tiles is taken from the planet's heightmap. Mines are kept
+	 * a few tiles in from the edges, so maps can't be too small.
+	 */
+	inline constexpr auto MinimumMapSize{NAS2D::Vector{32, 32}};
+	inline constexpr auto MaximumMapSize{NAS2D::Vector{4096, 4096}};
+
 	inline constexpr int RobotCommRange{15};
 	inline constexpr int LanderCommRange{5};
 
@@ -4,6 +4,8 @@
 #include "Map/TileMap.h"
 #include "Things/Structures/Structure.h"
 
+#include <array>
+
 
 using namespace NAS2D;
 
@@ -82,48 +84,56 @@ static bool validConnection(Structure* src, Structure* dst, Direction direction)
 
 GraphWalker::GraphWalker(const MapCoordinate& position, TileMap& tileMap, std::vector<Tile*>& tileList) :
 	mTileMap{tileMap},
-	mThisTile{tileMap.getTile(position)},
-	mTileList{tileList},
-	mPosition{position}
+	mTileList{tileList}
 {
-	walkGraph();
+	walkGraph(position);
 }
 
 
-void GraphWalker::walkGraph()
+void GraphWalker::walkGraph(const MapCoordinate& startPosition)
 {
-	mThisTile.connected(true);
-	mTileList.push_back(&mThisTile);
-
-	check(mPosition, Direction::Up);
-	check(mPosition, Direction::Down);
-	check(mPosition, Direction::North);
-	check(mPosition, Direction::East);
-	check(mPosition, Direction::South);
-	check(mPosition, Direction::West);
+	constexpr std::array Directions{Direction::Up, Direction::Down, Direction::North, Direction::East, Direction::South, Direction::West};
+
+	auto& startTile = mTileMap.getTile(startPosition);
+	startTile.connected(true);
+	mTileList.push_back(&startTile);
+
+	std::vector<MapCoordinate> openPositions{startPosition};
+	while (!openPositions.empty())
+	{
+		const auto position = openPositions.back();
+		openPositions.pop_back();
+
+		for (const auto direction : Directions)
+		{
+			if (!canWalk(mTileMap, position, direction)) { continue; }
+
+			const auto nextPosition = position.translate(direction);
+			auto& tile = mTileMap.getTile(nextPosition);
+			if (tile.connected()) { continue; }
+
+			tile.connected(true);
+			mTileList.push_back(&tile);
+			openPositions.push_back(nextPosition);
+		}
+	}
 }
 
 
 /**
- * Checks a given map location for a valid connection.
- *
- * \todo	With Tile being updated to include position information, this function can be modified
- *			to take a source and destination tile instead of looking them up. By using the internal
- *			positional information in the Tiles we can deduce direction between source and destination.
+ * Checks whether the structure at a map location connects to the structure
+ * in the given direction. Does not consider whether either is connected.
  */
-void GraphWalker::check(const MapCoordinate& fromPosition, Direction direction)
+bool GraphWalker::canWalk(TileMap& tileMap, const MapCoordinate& fromPosition, Direction direction)
 {
 	const auto position = fromPosition.translate(direction);
 
-	if (position.z < 0 || position.z > mTileMap.maxDepth()) { return; }
-	if (!NAS2D::Rectangle<int>::Create({0, 0}, mTileMap.size()).contains(position.xy)) { return; }
+	if (position.z < 0 || position.z > tileMap.maxDepth()) { return false; }
+	if (!NAS2D::Rectangle<int>::Create({0, 0}, tileMap.size()).contains(position.xy)) { return false; }
 
-	auto& tile = mTileMap.getTile(position);
+	auto& tile = tileMap.getTile(position);
 
-	if (tile.connected() || tile.mine() || !tile.excavated() || !tile.thingIsStructure()) { return; }
+	if (tile.mine() || !tile.excavated() || !tile.thingIsStructure()) { return false; }
 
-	if (validConnection(mThisTile.structure(), tile.structure(), direction))
-	{
-		GraphWalker walker(position, mTileMap, mTileList);
-	}
+	return validConnection(tileMap.getTile(fromPosition).structure(), tile.structure(), direction);
 }
@@ -15,6 +15,11 @@ class TileMap;
 /**
  * GraphWalker does a basic depth-first connection check
  *			on a TileMap given a starting point.
+ *
+ * Tiles that are already marked connected are treated as visited, so
+ * walking from a newly connected tile only visits tiles it newly connects.
+ * The walk keeps its own stack of positions rather than recursing so long
+ * tube networks can't exhaust the call stack.
  */
 class GraphWalker
 {
@@ -22,19 +27,17 @@ public:
 	GraphWalker(const MapCoordinate&, TileMap&, std::vector<Tile*>&);
 	~GraphWalker() = default;
 
+	static bool canWalk(TileMap& tileMap, const MapCoordinate& fromPosition, Direction direction);
+
 private:
 	GraphWalker() = delete;
 	GraphWalker(GraphWalker&) = delete;
 	GraphWalker& operator=(const GraphWalker&) = delete;
 
 private:
-	void walkGraph();
-	void check(const MapCoordinate& fromPosition, Direction direction);
+	void walkGraph(const MapCoordinate& startPosition);
 
 private:
 	TileMap& mTileMap;
-	Tile& mThisTile;
 	std::vector<Tile*>& mTileList;
-
-	MapCoordinate mPosition{};
 };
@@ -0,0 +1,85 @@
+#include "CoverageGrid.h"
+
+#include "TileMap.h"
+
+#include <algorithm>
+#include <utility>
+
+
+CoverageGrid::CoverageGrid(TileMap& tileMap, int depthCount) :
+	mTileMap{&tileMap},
+	mCovered(static_cast<std::size_t>(tileMap.size().x * tileMap.size().y * depthCount), false),
+	mTiles(static_cast<std::size_t>(depthCount))
+{
+}
+
+
+/**
+ * Replaces the covering ranges. Nothing is rasterized if they are the
+ * same as the ranges already in the grid.
+ */
+void CoverageGrid::update(std::vector<Source> sources)
+{
+	if (sources == mSources) { return; }
+
+	for (auto& depthTiles : mTiles)
+	{
+		for (const auto* tile : depthTiles)
+		{
+			mCovered[index(tile->xyz())] = false;
+		}
+		depthTiles.clear();
+	}
+
+	mSources = std::move(sources);
+	for (const auto& source : mSources)
+	{
+		rasterize(source);
+	}
+}
+
+
+bool CoverageGrid::covered(const MapCoordinate& position) const
+{
+	if (position.z < 0 || static_cast<std::size_t>(position.z) >= mTiles.size()) { return false; }
+	if (!mTileMap || !mTileMap->isValidPosition(position)) { return false; }
+
+	return mCovered[index(position)];
+}
+
+
+std::size_t CoverageGrid::index(const MapCoordinate& position) const
+{
+	const auto size = mTileMap->size();
+	return static_cast<std::size_t>((position.z * size.y + position.xy.y) * size.x + position.xy.x);
+}
+
+
+void CoverageGrid::rasterize(const Source& source)
+{
+	const auto size = mTileMap->size();
+	const auto center = source.center.xy;
+	const auto rangeSquared = source.range * source.range;
+	auto& depthTiles = mTiles[static_cast<std::size_t>(source.center.z)];
+
+	const auto start = NAS2D::Point{std::max(center.x - source.range, 0), std::max(center.y - source.range, 0)};
+	const auto end = NAS2D::Point{std::min(center.x + source.range + 1, size.x), std::min(center.y + source.range + 1, size.y)};
+	const auto area = NAS2D::Rectangle<int>::Create(start, end);
+	const auto sourceTiles = mTileMap->tiles(area, source.center.z);
+	for (int y = start.y; y < end.y; ++y)
+	{
+		const auto dy = y - center.y;
+		const auto row = sourceTiles.row(y);
+		for (int x = start.x; x < end.x; ++x)
+		{
+			const auto dx = x - center.x;
+			if (dx * dx + dy * dy > rangeSquared) { continue; }
+
+			const auto positionIndex = index({{x, y}, source.center.z});
+			if (mCovered[positionIndex]) { continue; }
+
+			mCovered[positionIndex] = true;
+			depthTiles.push_back(&row[static_cast<std::size_t>(x - start.x)]);
+		}
+	}
+}
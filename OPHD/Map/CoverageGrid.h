@@ -0,0 +1,53 @@
+#pragma once
+
+#include "MapCoordinate.h"
+
+#include <cstddef>
+#include <vector>
+
+
+class Tile;
+class TileMap;
+
+
+/**
+ * Per depth bitmap of the tiles inside the range of a set of structures,
+ * such as police stations or communication towers.
+ *
+ * The bitmap is only rasterized again when the set of covering ranges
+ * changes, and answers whether a position is covered with a single lookup.
+ * The covered tiles are also kept as lists for drawing overlays.
+ */
+class CoverageGrid
+{
+public:
+	struct Source
+	{
+		MapCoordinate center;
+		int range;
+
+		bool operator==(const Source& other) const
+		{
+			return center.xy == other.center.xy && center.z == other.center.z && range == other.range;
+		}
+	};
+
+	CoverageGrid() = default;
+	CoverageGrid(TileMap& tileMap, int depthCount);
+
+	void update(std::vector<Source> sources);
+
+	bool covered(const MapCoordinate& position) const;
+
+	const std::vector<Tile*>& tiles(int depth) const { return mTiles[static_cast<std::size_t>(depth)]; }
+	const std::vector<std::vector<Tile*>>& tiles() const { return mTiles; }
+
+private:
+	std::size_t index(const MapCoordinate& position) const;
+	void rasterize(const Source& source);
+
+	TileMap* mTileMap{nullptr};
+	std::vector<Source> mSources;
+	std::vector<bool> mCovered;
+	std::vector<std::vector<Tile*>> mTiles = std::vector<std::vector<Tile*>>(1); /**< Covered tiles by depth. An empty grid still has the surface. */
+};
@@ -0,0 +1,174 @@
+#include "DistanceField.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+
+namespace
+{
+	constexpr NAS2D::Vector<int> DirectionOffsets[] = {{0, -1}, {1, 0}, {0, 1}, {-1, 0}};
+}
+
+
+/**
+ * Rebuilds the field for a destination, discarding anything costing more
+ * than limit.
+ */
+void DistanceField::build(const RouteCostGrid& routeCosts, Index destination, Cost limit)
+{
+	const auto mapSize = routeCosts.size();
+	const auto destinationPosition = routeCosts.positionOf(destination);
+
+	mMapWidth = mapSize.x;
+	mDestination = destination;
+	mLimit = limit;
+	mMinCost = routeCosts.minCost();
+
+	// Every move after the first onto the destination costs at least minCost
+	const auto mapRadius = std::max(mapSize.x, mapSize.y);
+	const auto radius = mMinCost == 0 ? mapRadius : static_cast<int>(std::min<Cost>(limit / mMinCost + 1, static_cast<Cost>(mapRadius)));
+	const auto start = NAS2D::Point{std::max(0, destinationPosition.x - radius), std::max(0, destinationPosition.y - radius)};
+	const auto end = NAS2D::Point{std::min(mapSize.x, destinationPosition.x + radius + 1), std::min(mapSize.y, destinationPosition.y + radius + 1)};
+	mArea = NAS2D::Rectangle<int>::Create(start, end - start);
+
+	mCosts.assign(static_cast<std::size_t>(mArea.width) * static_cast<std::size_t>(mArea.height), RouteCostGrid::Impassable);
+
+	const auto slotOf = [this](NAS2D::Point<int> position)
+	{
+		return static_cast<std::size_t>((position.y - mArea.y) * mArea.width + (position.x - mArea.x));
+	};
+
+	using OpenNode = std::pair<Cost, Index>;
+	std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<OpenNode>> open;
+
+	mCosts[slotOf(destinationPosition)] = 0;
+	open.push({0, destination});
+
+	while (!open.empty())
+	{
+		const auto [cost, index] = open.top();
+		open.pop();
+
+		const auto position = routeCosts.positionOf(index);
+		if (cost > mCosts[slotOf(position)]) { continue; }
+
+		// Starts can't be driven through, so nothing is reached by way of them
+		const auto move = moveCost(routeCosts, index);
+		if (move == RouteCostGrid::Impassable) { continue; }
+
+		const auto newCost = cost + move;
+		if (newCost > limit) { continue; }
+
+		for (const auto offset : DirectionOffsets)
+		{
+			const auto neighborPosition = position + offset;
+			if (!mArea.contains(neighborPosition)) { continue; }
+
+			auto& neighborCost = mCosts[slotOf(neighborPosition)];
+			if (newCost < neighborCost)
+			{
+				neighborCost = newCost;
+				open.push({newCost, routeCosts.indexOf(neighborPosition)});
+			}
+		}
+	}
+}
+
+
+/**
+ * Cost of the cheapest route from a tile to the destination.
+ *
+ * \return	Cost or RouteCostGrid::Impassable if the tile can't reach the
+ *			destination within the limit.
+ */
+DistanceField::Cost DistanceField::cost(Index tile) const
+{
+	const NAS2D::Point position{static_cast<int>(tile % static_cast<Index>(mMapWidth)), static_cast<int>(tile / static_cast<Index>(mMapWidth))};
+	if (!mArea.contains(position)) { return RouteCostGrid::Impassable; }
+	return mCosts[static_cast<std::size_t>((position.y - mArea.y) * mArea.width + (position.x - mArea.x))];
+}
+
+
+/**
+ * Lowest cost of a tile and its neighbours.
+ *
+ * A route can only pass through a tile by way of a neighbour, so if this
+ * is more than a route costs, changing the tile can't affect that route.
+ */
+DistanceField::Cost DistanceField::nearestCost(Index tile) const
+{
+	const NAS2D::Point position{static_cast<int>(tile % static_cast<Index>(mMapWidth)), static_cast<int>(tile / static_cast<Index>(mMapWidth))};
+
+	auto lowest = cost(tile);
+	for (const auto offset : DirectionOffsets)
+	{
+		const auto neighborPosition = position + offset;
+		if (!mArea.contains(neighborPosition)) { continue; }
+		lowest = std::min(lowest, mCosts[static_cast<std::size_t>((neighborPosition.y - mArea.y) * mArea.width + (neighborPosition.x - mArea.x))]);
+	}
+	return lowest;
+}
+
+
+/**
+ * Follows the field downhill from a start tile to the destination.
+ *
+ * The RouteCostGrid must be the one the field was built from, unchanged
+ * since.
+ *
+ * \return	Every tile from start to the destination, or nothing if start
+ *			can't reach the destination within the limit.
+ */
+std::vector<DistanceField::Index> DistanceField::path(const RouteCostGrid& routeCosts, Index start) const
+{
+	std::vector<Index> tiles;
+	if (cost(start) == RouteCostGrid::Impassable) { return tiles; }
+
+	tiles.push_back(start);
+	auto current = start;
+	while (current != mDestination)
+	{
+		const auto currentCost = cost(current);
+		const auto position = routeCosts.positionOf(current);
+
+		auto next = current;
+		for (const auto offset : DirectionOffsets)
+		{
+			const auto neighborPosition = position + offset;
+			if (!mArea.contains(neighborPosition)) { continue; }
+
+			const auto neighbor = routeCosts.indexOf(neighborPosition);
+			const auto neighborCost = cost(neighbor);
+			const auto move = moveCost(routeCosts, neighbor);
+			if (neighborCost == RouteCostGrid::Impassable || move == RouteCostGrid::Impassable) { continue; }
+
+			if (neighborCost + move == currentCost)
+			{
+				next = neighbor;
+				break;
+			}
+		}
+
+		if (next == current)
+		{
+			throw std::runtime_error("DistanceField::path(): Field doesn't match the cost grid");
+		}
+
+		tiles.push_back(next);
+		current = next;
+	}
+
+	return tiles;
+}
+
+
+/**
+ * Cost to drive onto a tile on the way to the destination.
+ */
+DistanceField::Cost DistanceField::moveCost(const RouteCostGrid& routeCosts, Index tile) const
+{
+	return tile == mDestination ? routeCosts.endpointCost(tile) : routeCosts.passCost(tile);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "RouteCostGrid.h"
+
+#include <NAS2D/Math/Point.h>
+#include <NAS2D/Math/Rectangle.h>
+
+#include <vector>
+
+
+/**
+ * Cost of the cheapest route from every tile to one destination tile, up
+ * to a limit.
+ *
+ * Built with one Dijkstra search outward from the destination over a
+ * RouteCostGrid, following moves in reverse. The destination is treated
+ * as a route endpoint. Every other tile is a potential start, so a tile
+ * that can't be driven through, like one with a mine on it, still gets a
+ * cost if a neighbour can be.
+ *
+ * Only tiles within the limit are kept. They're stored in a window around
+ * the destination sized from the cheapest move on the grid, so memory use
+ * depends on the limit rather than the map size.
+ */
+class DistanceField
+{
+public:
+	using Index = RouteCostGrid::Index;
+	using Cost = RouteCostGrid::Cost;
+
+public:
+	DistanceField() = default;
+
+	void build(const RouteCostGrid& routeCosts, Index destination, Cost limit);
+
+	bool built() const { return !mCosts.empty(); }
+
+	Index destination() const { return mDestination; }
+	Cost limit() const { return mLimit; }
+	Cost minCost() const { return mMinCost; }
+
+	Cost cost(Index tile) const;
+	Cost nearestCost(Index tile) const;
+
+	std::vector<Index> path(const RouteCostGrid& routeCosts, Index start) const;
+
+private:
+	Cost moveCost(const RouteCostGrid& routeCosts, Index tile) const;
+
+	NAS2D::Rectangle<int> mArea;
+	int mMapWidth{0};
+	Index mDestination{0};
+	Cost mLimit{0};
+	Cost mMinCost{RouteCostGrid::Impassable};
+	std::vector<Cost> mCosts;
+};
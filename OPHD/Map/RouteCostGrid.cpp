@@ -0,0 +1,110 @@
+#include "RouteCostGrid.h"
+
+#include "TileMap.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+
+
+RouteCostGrid::RouteCostGrid(NAS2D::Vector<int> size) :
+	mSize{size}
+{
+	if (mSize.x <= 0 || mSize.y <= 0)
+	{
+		throw std::runtime_error("RouteCostGrid size must be greater than zero");
+	}
+
+	const auto tileCount = static_cast<std::size_t>(mSize.x) * static_cast<std::size_t>(mSize.y);
+	mPassCost.resize(tileCount, Impassable);
+	mEndpointCost.resize(tileCount, Impassable);
+}
+
+
+/**
+ * Marks every tile to be recomputed by the next update().
+ */
+void RouteCostGrid::invalidate()
+{
+	mAllChanged = true;
+	mChangedTiles.clear();
+}
+
+
+/**
+ * Marks a tile to be recomputed by the next update().
+ */
+void RouteCostGrid::invalidate(NAS2D::Point<int> position)
+{
+	if (mAllChanged) { return; }
+	mChangedTiles.push_back(indexOf(position));
+}
+
+
+/**
+ * Recomputes the costs of every tile marked since the last update.
+ */
+void RouteCostGrid::update(const TileMap& tileMap)
+{
+	if (tileMap.size() != mSize)
+	{
+		throw std::runtime_error("RouteCostGrid::update(): TileMap size doesn't match");
+	}
+
+	if (mAllChanged || !mChangedTiles.empty()) { ++mRevision; }
+
+	if (mAllChanged)
+	{
+		mMinCost = Impassable;
+		mMaxCost = 0;
+		for (Index index = 0; index < tileCount(); ++index)
+		{
+			updateTile(tileMap, index);
+		}
+		mAllChanged = false;
+	}
+
+	for (const auto index : mChangedTiles)
+	{
+		updateTile(tileMap, index);
+	}
+	mChangedTiles.clear();
+}
+
+
+/**
+ * Converts a cost from TileMap::routeCost() to fixed point.
+ */
+RouteCostGrid::Cost RouteCostGrid::toCost(float cost)
+{
+	if (cost == FLT_MAX) { return Impassable; }
+	return static_cast<Cost>(std::lround(cost * CostScale));
+}
+
+
+float RouteCostGrid::toFloat(Cost cost)
+{
+	if (cost == Impassable) { return FLT_MAX; }
+	return static_cast<float>(cost) / CostScale;
+}
+
+
+void RouteCostGrid::updateTile(const TileMap& tileMap, Index index)
+{
+	const auto position = positionOf(index);
+	const auto passCost = toCost(tileMap.routeCost(position, false));
+	const auto endpointCost = toCost(tileMap.routeCost(position, true));
+
+	mPassCost[index] = passCost;
+	mEndpointCost[index] = endpointCost;
+
+	// Search heuristics have to stay at or under the cheapest move, so the
+	// minimum is only ever lowered. Costs going up just make them less tight.
+	for (const auto value : {passCost, endpointCost})
+	{
+		if (value == Impassable) { continue; }
+		mMinCost = std::min(mMinCost, value);
+		mMaxCost = std::max(mMaxCost, value);
+	}
+}
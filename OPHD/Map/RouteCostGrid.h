@@ -0,0 +1,75 @@
+#pragma once
+
+#include <NAS2D/Math/Point.h>
+#include <NAS2D/Math/Vector.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+
+class TileMap;
+
+
+/**
+ * What it costs a truck to drive onto each surface tile, in flat arrays
+ * indexed by tile.
+ *
+ * Values come from TileMap::routeCost() and are kept as integers counting
+ * quarters, which every cost in the game divides into evenly. Each tile
+ * has two costs: one for driving through it and one for a tile that is the
+ * start or end of a route, so searches don't have to be told their
+ * endpoints through TileMap.
+ *
+ * Tiles are recomputed lazily. Anything that changes a tile's cost marks
+ * it with invalidate() and the next update() recomputes only marked tiles.
+ */
+class RouteCostGrid
+{
+public:
+	using Index = std::uint32_t;
+	using Cost = std::uint32_t;
+
+	static constexpr Cost Impassable = std::numeric_limits<Cost>::max();
+	static constexpr float CostScale = 4.0f;
+
+public:
+	explicit RouteCostGrid(NAS2D::Vector<int> size);
+
+	NAS2D::Vector<int> size() const { return mSize; }
+	Index tileCount() const { return static_cast<Index>(mPassCost.size()); }
+
+	Index indexOf(NAS2D::Point<int> position) const { return static_cast<Index>(position.y * mSize.x + position.x); }
+	NAS2D::Point<int> positionOf(Index index) const { return {static_cast<int>(index) % mSize.x, static_cast<int>(index) / mSize.x}; }
+
+	Cost passCost(Index index) const { return mPassCost[index]; }
+	Cost endpointCost(Index index) const { return mEndpointCost[index]; }
+
+	Cost minCost() const { return mMinCost; }
+	Cost maxCost() const { return mMaxCost; }
+
+	std::uint32_t revision() const { return mRevision; }
+
+	void invalidate();
+	void invalidate(NAS2D::Point<int> position);
+	void update(const TileMap& tileMap);
+
+	static Cost toCost(float cost);
+	static float toFloat(Cost cost);
+
+private:
+	void updateTile(const TileMap& tileMap, Index index);
+
+	const NAS2D::Vector<int> mSize;
+
+	std::vector<Cost> mPassCost; /**< Cost to drive onto a tile on the way somewhere else. */
+	std::vector<Cost> mEndpointCost; /**< Cost to drive onto a tile that starts or ends the route. */
+
+	Cost mMinCost{Impassable};
+	Cost mMaxCost{0};
+
+	std::vector<Index> mChangedTiles;
+	bool mAllChanged{true};
+	std::uint32_t mRevision{0}; /**< Bumped by every update() that changed anything. */
+};
@@ -5,48 +5,6 @@
 #include "../Things/Structures/Structure.h"
 
 
-Tile::Tile(const MapCoordinate& position, TerrainType index) :
-	mIndex{index},
-	mPosition{position}
-{}
-
-
-Tile::Tile(Tile&& other) noexcept :
-	mIndex{other.mIndex},
-	mPosition{other.mPosition},
-	mThing{other.mThing},
-	mMine{other.mMine},
-	mOverlay{other.mOverlay},
-	mExcavated{other.mExcavated}
-{
-	other.mThing = nullptr;
-	other.mMine = nullptr;
-}
-
-
-Tile& Tile::operator=(Tile&& other) noexcept
-{
-	mIndex = other.mIndex;
-	mPosition = other.mPosition;
-	mThing = other.mThing;
-	mMine = other.mMine;
-	mOverlay = other.mOverlay;
-	mExcavated = other.mExcavated;
-
-	other.mThing = nullptr;
-	other.mMine = nullptr;
-
-	return *this;
-}
-
-
-Tile::~Tile()
-{
-	delete mMine;
-	delete mThing;
-}
-
-
 /**
  * Adds a new Thing to the tile.
  *
@@ -54,16 +12,16 @@ Tile::~Tile()
  */
 void Tile::pushThing(Thing* thing)
 {
-	if (mThing)
+	if (auto* currentThing = this->thing())
 	{
-		if (mThing == thing)
+		if (currentThing == thing)
 		{
 			throw std::runtime_error("Attempting to pushThing on a tile where it's already set");
 		}
 		deleteThing();
 	}
 
-	mThing = thing;
+	mChunk->storage().thing(*mChunk, mOffset, thing);
 }
 
 
@@ -74,7 +32,7 @@ void Tile::pushThing(Thing* thing)
  */
 void Tile::deleteThing()
 {
-	delete mThing;
+	delete thing();
 	removeThing();
 }
 
@@ -86,14 +44,14 @@ void Tile::deleteThing()
  */
 void Tile::removeThing()
 {
-	mThing = nullptr;
+	mChunk->storage().thing(*mChunk, mOffset, nullptr);
 }
 
 
 void Tile::pushMine(Mine* mine)
 {
-	delete mMine;
-	mMine = mine;
+	delete mChunk->mine(mOffset);
+	mChunk->storage().mine(*mChunk, mOffset, mine);
 }
 
 
@@ -3,10 +3,13 @@
 #include "../Common.h"
 
 #include "MapCoordinate.h"
+#include "TileStorage.h"
 
 #include <NAS2D/Math/Point.h>
 #include <NAS2D/Math/Vector.h>
 
+#include <cstdint>
+
 
 class Mine;
 class Thing;
@@ -14,6 +17,13 @@ class Robot;
 class Structure;
 
 
+/**
+ * A tile of a TileMap.
+ *
+ * Tiles don't hold their own state. Each one is a handle into a chunk of
+ * the packed TileStorage of its map, so a Tile reference or pointer stays
+ * valid for as long as the map does.
+ */
 class Tile
 {
 public:
@@ -28,35 +38,36 @@ public:
 	};
 
 public:
-	Tile() = default;
-	Tile(const MapCoordinate& position, TerrainType);
+	Tile(TileChunk& chunk, TileChunk::Offset offset) :
+		mChunk{&chunk},
+		mOffset{offset}
+	{}
 	Tile(const Tile&) = delete;
 	Tile& operator=(const Tile&) = delete;
-	Tile(Tile&&) noexcept;
-	Tile& operator=(Tile&&) noexcept;
-	~Tile();
+	Tile(Tile&&) noexcept = default;
+	Tile& operator=(Tile&&) noexcept = default;
+	~Tile() = default;
 
-	TerrainType index() const { return mIndex; }
-	void index(TerrainType index) { mIndex = index; }
+	TerrainType index() const { return mChunk->terrain(mOffset); }
+	void index(TerrainType index) { mChunk->terrain(mOffset, index); }
 
-	const MapCoordinate& xyz() const { return mPosition; }
-	NAS2D::Point<int> xy() const { return mPosition.xy; }
-	int depth() const { return mPosition.z; }
-	void depth(int i) { mPosition.z = i; }
+	MapCoordinate xyz() const { return mChunk->positionOf(mOffset); }
+	NAS2D::Point<int> xy() const { return xyz().xy; }
+	int depth() const { return mChunk->level(); }
 
 	bool bulldozed() const { return index() == TerrainType::Dozed; }
 
-	bool excavated() const { return mExcavated; }
-	void excavated(bool value) { mExcavated = value; }
+	bool excavated() const { return mChunk->excavated(mOffset); }
+	void excavated(bool value) { mChunk->excavated(mOffset, value); }
 
-	bool connected() const { return mConnected; }
-	void connected(bool value) { mConnected = value; }
+	bool connected() const { return mChunk->connected(mOffset); }
+	void connected(bool value) { mChunk->connected(mOffset, value); }
 
-	Thing* thing() const { return mThing; }
+	Thing* thing() const { return mChunk->thing(mOffset); }
 
-	bool empty() const { return mThing == nullptr; }
+	bool empty() const { return thing() == nullptr; }
 
-	bool hasMine() const { return mMine != nullptr; }
+	bool hasMine() const { return mChunk->mine(mOffset) != nullptr; }
 
 	Structure* structure() const;
 	Robot* robot() const;
@@ -69,23 +80,14 @@ public:
 
 	void removeThing();
 
-	const Mine* mine() const { return mMine; }
-	Mine* mine() { return mMine; }
+	const Mine* mine() const { return mChunk->mine(mOffset); }
+	Mine* mine() { return mChunk->mine(mOffset); }
 	void pushMine(Mine*);
 
-	void overlay(Overlay overlay) { mOverlay = overlay; }
-	Overlay overlay() const { return mOverlay; }
+	void overlay(Overlay overlay) { mChunk->overlay(mOffset, static_cast<std::uint8_t>(overlay)); }
+	Overlay overlay() const { return static_cast<Overlay>(mChunk->overlay(mOffset)); }
 
 private:
-	TerrainType mIndex = TerrainType::Dozed;
-
-	MapCoordinate mPosition;
-
-	Thing* mThing = nullptr;
-	Mine* mMine = nullptr;
-
-	Overlay mOverlay{Overlay::None};
-
-	bool mExcavated = true; /**< Used when a Digger uncovers underground tiles. */
-	bool mConnected = false; /**< Flag indicating that this tile is connected to the Command Center. */
+	TileChunk* mChunk;
+	TileChunk::Offset mOffset;
 };
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Tile.h"
+
+#include <NAS2D/Math/Point.h>
+#include <NAS2D/Math/Rectangle.h>
+
+#include <cstddef>
+#include <span>
+
+
+/**
+ * A rectangle of tiles on one level of a TileMap, handed out by
+ * TileMap::tiles() after checking once that the whole rectangle is on the
+ * map.
+ *
+ * Iterating gives each row of the rectangle as a contiguous span of tiles,
+ * top to bottom. Lookups inside the rectangle aren't checked again, so
+ * loops over many tiles don't pay for bounds checks on every one.
+ */
+class TileArea
+{
+public:
+	class RowIterator
+	{
+	public:
+		RowIterator(const TileArea& area, int y) :
+			mArea{&area},
+			mY{y}
+		{}
+
+		std::span<Tile> operator*() const { return mArea->row(mY); }
+
+		RowIterator& operator++()
+		{
+			++mY;
+			return *this;
+		}
+
+		bool operator!=(const RowIterator& other) const { return mY != other.mY; }
+
+	private:
+		const TileArea* mArea;
+		int mY;
+	};
+
+public:
+	TileArea(TileStorage& storage, const NAS2D::Rectangle<int>& area, int depth) :
+		mStorage{&storage},
+		mArea{area},
+		mDepth{depth}
+	{}
+
+	const NAS2D::Rectangle<int>& area() const { return mArea; }
+	int depth() const { return mDepth; }
+
+	bool contains(NAS2D::Point<int> position) const { return mArea.contains(position); }
+
+	/**
+	 * Tiles in a row of the rectangle, with y in map coordinates.
+	 *
+	 * \warning	y must be within the rectangle.
+	 */
+	std::span<Tile> row(int y) const
+	{
+		return mStorage->row(mDepth, y).subspan(static_cast<std::size_t>(mArea.x), static_cast<std::size_t>(mArea.width));
+	}
+
+	/**
+	 * Tile at a position in map coordinates.
+	 *
+	 * \warning	position must be within the rectangle. Check with contains()
+	 *			if it might not be.
+	 */
+	Tile& operator[](NAS2D::Point<int> position) const
+	{
+		return mStorage->tile({position, mDepth});
+	}
+
+	RowIterator begin() const { return {*this, mArea.y}; }
+	RowIterator end() const { return {*this, mArea.y + mArea.height}; }
+
+private:
+	TileStorage* mStorage;
+	NAS2D::Rectangle<int> mArea;
+	int mDepth;
+};
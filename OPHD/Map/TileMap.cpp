@@ -1,5 +1,6 @@
 #include "TileMap.h"
 
+#include "../Cache.h"
 #include "../Constants/Numbers.h"
 #include "../Constants/UiConstants.h"
 #include "../DirectionOffset.h"
@@ -11,11 +12,13 @@
 #include <NAS2D/Utility.h>
 #include <NAS2D/ParserHelper.h>
 #include <NAS2D/Xml/XmlElement.h>
-#include <NAS2D/Math/PointInRectangleRange.h>
 
 #include <algorithm>
 #include <functional>
 #include <array>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
 
 using namespace NAS2D;
@@ -23,14 +26,30 @@ using namespace NAS2D;
 
 namespace {
 	const std::string MapTerrainExtension = "_a.png";
-	const auto MapSize = NAS2D::Vector{300, 150};
+
+
+	NAS2D::Vector<int> checkedMapSize(NAS2D::Vector<int> size)
+	{
+		const auto& minSize = constants::MinimumMapSize;
+		const auto& maxSize = constants::MaximumMapSize;
+		if (size.x < minSize.x || size.y < minSize.y || size.x > maxSize.x || size.y > maxSize.y)
+		{
+			throw std::runtime_error(
+				"Map size " + std::to_string(size.x) + "x" + std::to_string(size.y) + " is outside of " +
+				std::to_string(minSize.x) + "x" + std::to_string(minSize.y) + " to " +
+				std::to_string(maxSize.x) + "x" + std::to_string(maxSize.y)
+			);
+		}
+		return size;
+	}
+
 
 	std::vector<NAS2D::Point<int>> generateMineLocations(NAS2D::Vector<int> mapSize, std::size_t mineCount)
 	{
 		auto randPoint = [mapSize]() {
 			return NAS2D::Point{
-				randomNumber.generate<int>(5, mapSize.x - 5),
-				randomNumber.generate<int>(5, mapSize.y - 5)
+				randomStreams[RandomStream::MinePlacement].generate<int>(5, mapSize.x - 5),
+				randomStreams[RandomStream::MinePlacement].generate<int>(5, mapSize.y - 5)
 			};
 		};
 
@@ -65,7 +84,7 @@ namespace {
 		const auto total = std::accumulate(mineYields.begin(), mineYields.end(), 0);
 
 		const auto randYield = [mineYields, total]() {
-			const auto randValue = randomNumber.generate<int>(1, total);
+			const auto randValue = randomStreams[RandomStream::MinePlacement].generate<int>(1, total);
 			return (randValue <= mineYields[0]) ? MineProductionRate::Low :
 				(randValue <= mineYields[0] + mineYields[1]) ? MineProductionRate::Medium :
 				MineProductionRate::High;
@@ -90,10 +109,37 @@ TileMap::TileMap(const std::string& mapPath, int maxDepth, int mineCount, const
 
 
 TileMap::TileMap(const std::string& mapPath, int maxDepth) :
-	mSizeInTiles{MapSize},
-	mMaxDepth{maxDepth}
+	TileMap{imageCache.load(mapPath + MapTerrainExtension), maxDepth}
+{}
+
+
+/**
+ * Creates a map the size of its heightmap.
+ *
+ * The heightmap comes from the image cache, where the MiniMap finds it
+ * already decoded.
+ */
+TileMap::TileMap(const NAS2D::Image& heightmap, int maxDepth) :
+	mSizeInTiles{checkedMapSize(heightmap.size())},
+	mMaxDepth{maxDepth},
+	mTileStorage{mSizeInTiles, mMaxDepth + 1},
+	mRouteCosts{mSizeInTiles}
 {
-	buildTerrainMap(mapPath);
+	buildTerrainMap(heightmap);
+}
+
+
+/**
+ * Creates a map of Clear terrain without loading a heightmap, for tools
+ * that build their own terrain.
+ */
+TileMap::TileMap(NAS2D::Vector<int> sizeInTiles, int maxDepth) :
+	mSizeInTiles{checkedMapSize(sizeInTiles)},
+	mMaxDepth{maxDepth},
+	mTileStorage{mSizeInTiles, mMaxDepth + 1},
+	mRouteCosts{mSizeInTiles}
+{
+	mTileStorage.terrain(std::vector<TerrainType>(mTileStorage.levelTileCount(), TerrainType::Clear));
 }
 
 
@@ -117,31 +163,42 @@ bool TileMap::isValidPosition(const MapCoordinate& position) const
 
 
 const Tile& TileMap::getTile(const MapCoordinate& position) const
+{
+	// Tile handles are made the first time they're asked for
+	return const_cast<TileMap&>(*this).getTile(position);
+}
+
+
+Tile& TileMap::getTile(const MapCoordinate& position)
 {
 	if (!isValidPosition(position))
 	{
 		throw std::runtime_error("Tile coordinates out of bounds: {" + std::to_string(position.xy.x) + ", " + std::to_string(position.xy.y) + ", " + std::to_string(position.z) + "}");
 	}
-	const auto mapPosition = position.xy.to<std::size_t>();
-	const auto level = static_cast<std::size_t>(position.z);
-	return mTileMap[((level * mSizeInTiles.y) + mapPosition.y) * mSizeInTiles.x + mapPosition.x];
+	return mTileStorage.tile(position);
 }
 
 
-Tile& TileMap::getTile(const MapCoordinate& position)
+/**
+ * Rows of tiles in a rectangle on one level, for loops that visit many
+ * tiles. The rectangle is checked once here instead of on every tile.
+ *
+ * \throws	std::runtime_error if any part of the rectangle is off the map.
+ */
+TileArea TileMap::tiles(const NAS2D::Rectangle<int>& area, int depth)
 {
-	const auto& constThis = *this;
-	return const_cast<Tile&>(constThis.getTile(position));
+	const auto end = area.endPoint();
+	if (area.x < 0 || area.y < 0 || area.width < 0 || area.height < 0 || end.x > mSizeInTiles.x || end.y > mSizeInTiles.y || depth < 0 || depth > mMaxDepth)
+	{
+		throw std::runtime_error("Tile area out of bounds: {" + std::to_string(area.x) + ", " + std::to_string(area.y) + ", " + std::to_string(area.width) + ", " + std::to_string(area.height) + "} at depth " + std::to_string(depth));
+	}
+
+	return {mTileStorage, area, depth};
 }
 
 
-void TileMap::buildTerrainMap(const std::string& path)
+void TileMap::buildTerrainMap(const NAS2D::Image& heightmap)
 {
-	const Image heightmap(path + MapTerrainExtension);
-
-	const auto levelCount = static_cast<std::size_t>(mMaxDepth) + 1;
-	mTileMap.resize(mSizeInTiles.x * mSizeInTiles.y * levelCount);
-
 	/**
 	 * Builds a terrain map based on the pixel color values in
 	 * a maps height map.
@@ -149,17 +206,20 @@ void TileMap::buildTerrainMap(const std::string& path)
 	 * Height maps by default are in grey-scale. This method assumes
 	 * that all channels are the same value so it only looks at the red.
 	 * Color values are divided by 50 to get a height value from 1 - 4.
+	 *
+	 * The heightmap is read once into a plane of one byte per tile, which
+	 * TileStorage takes over as the terrain every level starts from.
 	 */
-	for (int depth = 0; depth <= mMaxDepth; depth++)
+	std::vector<TerrainType> terrain(mTileStorage.levelTileCount());
+	auto* tileTerrain = terrain.data();
+	for (int y = 0; y < mSizeInTiles.y; ++y)
 	{
-		for (const auto point : PointInRectangleRange{Rectangle<int>::Create({0, 0}, mSizeInTiles)})
+		for (int x = 0; x < mSizeInTiles.x; ++x)
 		{
-			auto color = heightmap.pixelColor(point);
-			auto& tile = getTile({point, depth});
-			tile = {{point, depth}, static_cast<TerrainType>(color.red / 50)};
-			if (depth > 0) { tile.excavated(false); }
+			*tileTerrain++ = static_cast<TerrainType>(heightmap.pixelColor({x, y}).red / 50);
 		}
 	}
+	mTileStorage.terrain(std::move(terrain));
 }
 
 
@@ -185,25 +245,31 @@ void TileMap::serialize(NAS2D::Xml::XmlElement* element)
 	element->linkEndChild(tiles);
 
 	// We're only writing out tiles that don't have structures or robots in them that are
-	// underground and excavated or surface and bulldozed.
-	for (int depth = 0; depth <= maxDepth(); ++depth)
+	// underground and excavated or surface and bulldozed. Underground chunks nothing has
+	// excavated into yet have none of those.
+	for (std::size_t chunkIndex = 0; chunkIndex < mTileStorage.chunkCount(); ++chunkIndex)
 	{
-		for (const auto point : PointInRectangleRange{Rectangle<int>::Create({0, 0}, mSizeInTiles)})
+		const auto& chunk = mTileStorage.chunk(chunkIndex);
+		if (!chunk.materialized()) { continue; }
+
+		const bool isUnderground = chunk.level() > 0;
+		for (TileChunk::Offset offset = 0; offset < chunk.tileCount(); ++offset)
 		{
-			auto& tile = getTile({point, depth});
+			const auto terrain = chunk.terrain(offset);
 			if (
-				((depth > 0 && tile.excavated()) || (tile.index() == TerrainType::Dozed)) &&
-				(tile.empty() && tile.mine() == nullptr)
+				((isUnderground && chunk.excavated(offset)) || (terrain == TerrainType::Dozed)) &&
+				chunk.slot(offset) == TileStorage::NoSlot
 			)
 			{
+				const auto position = chunk.positionOf(offset);
 				tiles->linkEndChild(
 					NAS2D::dictionaryToAttributes(
 						"tile",
 						{{
-							{"x", point.x},
-							{"y", point.y},
-							{"depth", depth},
-							{"index", static_cast<int>(tile.index())},
+							{"x", position.xy.x},
+							{"y", position.xy.y},
+							{"depth", position.z},
+							{"index", static_cast<int>(terrain)},
 						}}
 					)
 				);
@@ -247,6 +313,8 @@ void TileMap::deserialize(NAS2D::Xml::XmlElement* element)
 
 		if (depth > 0) { tile.excavated(true); }
 	}
+
+	mRouteCosts.invalidate();
 }
 
 
@@ -265,6 +333,7 @@ void TileMap::AdjacentCost(void* state, std::vector<micropather::StateCost>* adj
 {
 	auto& tile = *static_cast<Tile*>(state);
 	const auto tilePosition = tile.xy();
+	const auto& costs = routeCosts();
 
 	for (const auto& offset : DirectionClockwise4)
 	{
@@ -274,53 +343,114 @@ void TileMap::AdjacentCost(void* state, std::vector<micropather::StateCost>* adj
 			continue;
 		}
 
-		auto& adjacentTile = getTile({position, 0});
-		float cost = constants::RouteBaseCost;
+		auto& adjacentTile = mTileStorage.tile({position, 0});
+		const auto index = costs.indexOf(position);
+		const bool isEndpoint = &adjacentTile == mPathStartEndPair.first || &adjacentTile == mPathStartEndPair.second;
+		const float cost = RouteCostGrid::toFloat(isEndpoint ? costs.endpointCost(index) : costs.passCost(index));
 
-		if (adjacentTile.index() == TerrainType::Impassable)
+		micropather::StateCost nodeCost = {&adjacentTile, cost};
+		adjacent->push_back(nodeCost);
+	}
+}
+
+
+/**
+ * MicroPather can't say which tiles a route starts and ends at when
+ * it asks for adjacent costs, so it has to be told up front.
+ */
+void TileMap::pathStartAndEnd(void* start, void* end)
+{
+	mPathStartEndPair = std::make_pair(start, end);
+}
+
+
+/**
+ * Cost for a truck to move onto a surface tile.
+ *
+ * Structures other than roads can't be driven through and cost FLT_MAX
+ * unless the tile is one of the endpoints of the route being planned.
+ */
+float TileMap::routeCost(const Tile& tile, bool isEndpoint) const
+{
+	return routeCost(tile.xy(), isEndpoint);
+}
+
+
+/**
+ * Cost for a truck to move onto the surface tile at a position.
+ *
+ * Reads the tile's state straight from storage, so passes over the whole
+ * surface don't have to make a Tile handle for every tile.
+ */
+float TileMap::routeCost(NAS2D::Point<int> position, bool isEndpoint) const
+{
+	const auto& chunk = mTileStorage.chunkAt(0, position.y);
+	const auto offset = mTileStorage.offsetOf(position);
+	const auto terrain = chunk.terrain(offset);
+	const auto* thing = chunk.thing(offset);
+
+	float cost = constants::RouteBaseCost;
+
+	if (terrain == TerrainType::Impassable)
+	{
+		cost = FLT_MAX;
+	}
+	else if (thing)
+	{
+		const auto* structure = dynamic_cast<const Structure*>(thing);
+		if (isEndpoint)
 		{
-			cost = FLT_MAX;
+			cost *= static_cast<float>(terrain) + 1.0f;
 		}
-		else if (!adjacentTile.empty())
+		else if (structure && structure->structureId() == StructureID::SID_ROAD)
 		{
-			if (&adjacentTile == mPathStartEndPair.first || &adjacentTile == mPathStartEndPair.second)
+			const Structure& road = *structure;
+
+			if (road.state() != StructureState::Operational)
 			{
-				cost *= static_cast<float>(adjacentTile.index()) + 1.0f;
+				cost *= static_cast<float>(TerrainType::Difficult) + 1.0f;
 			}
-			else if (adjacentTile.thingIsStructure() && adjacentTile.structure()->structureId() == StructureID::SID_ROAD)
+			else if (road.integrity() < constants::RoadIntegrityChange)
 			{
-				Structure& road = *adjacentTile.structure();
-
-				if (road.state() != StructureState::Operational)
-				{
-					cost *= static_cast<float>(TerrainType::Difficult) + 1.0f;
-				}
-				else if (road.integrity() < constants::RoadIntegrityChange)
-				{
-					cost = 0.75f;
-				}
-				else
-				{
-					cost = 0.5f;
-				}		
+				cost = 0.75f;
 			}
 			else
 			{
-				cost = FLT_MAX;
+				cost = 0.5f;
 			}
 		}
 		else
 		{
-			cost *= static_cast<float>(adjacentTile.index()) + 1.0f;
+			cost = FLT_MAX;
 		}
-
-		micropather::StateCost nodeCost = {&adjacentTile, cost};
-		adjacent->push_back(nodeCost);
 	}
+	else
+	{
+		cost *= static_cast<float>(terrain) + 1.0f;
+	}
+
+	return cost;
 }
 
 
-void TileMap::pathStartAndEnd(void* start, void* end)
+/**
+ * Surface route costs, with any tiles that changed since the last call
+ * brought up to date.
+ */
+const RouteCostGrid& TileMap::routeCosts()
 {
-	mPathStartEndPair = std::make_pair(start, end);
+	mRouteCosts.update(*this);
+	return mRouteCosts;
+}
+
+
+/**
+ * Marks a tile's route cost to be recomputed. Needs to be called whenever
+ * something changes that routeCost() depends on: a structure being built
+ * or removed, a road's condition or terrain being dozed.
+ */
+void TileMap::invalidateRouteCost(const Tile& tile)
+{
+	if (tile.depth() != 0) { return; }
+	mRouteCosts.invalidate(tile.xy());
 }
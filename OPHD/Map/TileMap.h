@@ -1,6 +1,9 @@
 #pragma once
 
 #include "Tile.h"
+#include "TileArea.h"
+#include "TileStorage.h"
+#include "RouteCostGrid.h"
 
 #include "../MicroPather/micropather.h"
 
@@ -33,6 +36,7 @@ public:
 
 	TileMap(const std::string& mapPath, int maxDepth, int mineCount, const MineYields& mineYields);
 	TileMap(const std::string& mapPath, int maxDepth);
+	TileMap(NAS2D::Vector<int> sizeInTiles, int maxDepth);
 	TileMap(const TileMap&) = delete;
 	TileMap& operator=(const TileMap&) = delete;
 
@@ -44,6 +48,13 @@ public:
 	const Tile& getTile(const MapCoordinate& position) const;
 	Tile& getTile(const MapCoordinate& position);
 
+	TileArea tiles(const NAS2D::Rectangle<int>& area, int depth);
+
+	const TileStorage& tileStorage() const { return mTileStorage; }
+
+	void clearConnected() { mTileStorage.clearConnected(); }
+	void clearOverlays() { mTileStorage.clearOverlays(); }
+
 	const std::vector<NAS2D::Point<int>>& mineLocations() const { return mMineLocations; }
 	void removeMineLocation(const NAS2D::Point<int>& pt);
 
@@ -58,14 +69,23 @@ public:
 
 	void pathStartAndEnd(void* start, void* end);
 
+	float routeCost(const Tile& tile, bool isEndpoint) const;
+	float routeCost(NAS2D::Point<int> position, bool isEndpoint) const;
+
+	const RouteCostGrid& routeCosts();
+	void invalidateRouteCost(const Tile& tile);
+
 private:
-	void buildTerrainMap(const std::string& path);
+	TileMap(const NAS2D::Image& heightmap, int maxDepth);
+
+	void buildTerrainMap(const NAS2D::Image& heightmap);
 
 
 	const NAS2D::Vector<int> mSizeInTiles;
 	const int mMaxDepth = 0;
-	std::vector<Tile> mTileMap;
+	TileStorage mTileStorage;
 	std::vector<NAS2D::Point<int>> mMineLocations;
+	RouteCostGrid mRouteCosts;
 
 	std::string mMapPath;
 
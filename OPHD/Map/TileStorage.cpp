@@ -0,0 +1,315 @@
+#include "TileStorage.h"
+
+#include "Tile.h"
+#include "../Mine.h"
+#include "../StorableResources.h"
+#include "../Things/Thing.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+
+namespace
+{
+	constexpr auto NoOverlay = static_cast<std::uint8_t>(Tile::Overlay::None);
+}
+
+
+TileChunk::Planes::Planes(std::size_t tileCount, bool isExcavated, std::uint8_t noOverlay) :
+	overlay(tileCount, noOverlay),
+	excavated(tileCount, isExcavated),
+	connected(tileCount, false),
+	occupancy(tileCount, TileStorage::NoSlot)
+{}
+
+
+TileChunk::TileChunk(TileStorage& storage, int level, int firstRow, int rowCount) :
+	mStorage{storage},
+	mLevel{level},
+	mFirstRow{firstRow},
+	mRowCount{rowCount},
+	mTileCount{static_cast<Offset>(rowCount * storage.levelSize().x)},
+	mTerrain{storage.terrain().data() + static_cast<std::size_t>(firstRow * storage.levelSize().x)},
+	mPlanes{&storage.unexcavatedPlanes()},
+	mRows(static_cast<std::size_t>(rowCount))
+{}
+
+
+TileChunk::~TileChunk() = default;
+
+
+MapCoordinate TileChunk::positionOf(Offset offset) const
+{
+	const auto width = static_cast<Offset>(mStorage.levelSize().x);
+	return {{static_cast<int>(offset % width), mFirstRow + static_cast<int>(offset / width)}, mLevel};
+}
+
+
+/**
+ * Gives the chunk planes of its own, starting from the unexcavated state
+ * and the heightmap terrain. Surface chunks start out excavated.
+ */
+void TileChunk::materialize()
+{
+	if (materialized()) { return; }
+
+	mOwnPlanes = std::make_unique<Planes>(mTileCount, mLevel == 0, NoOverlay);
+	mOwnPlanes->terrain.assign(mTerrain, mTerrain + mTileCount);
+	mTerrain = mOwnPlanes->terrain.data();
+	mPlanes = mOwnPlanes.get();
+}
+
+
+void TileChunk::terrain(Offset offset, TerrainType terrain)
+{
+	if (!materialized() && mTerrain[offset] == terrain) { return; }
+	materialize();
+	mOwnPlanes->terrain[offset] = terrain;
+}
+
+
+void TileChunk::excavated(Offset offset, bool value)
+{
+	if (!materialized() && !value) { return; }
+	materialize();
+	mOwnPlanes->excavated.set(offset, value);
+}
+
+
+void TileChunk::connected(Offset offset, bool value)
+{
+	if (!materialized() && !value) { return; }
+	materialize();
+	mOwnPlanes->connected.set(offset, value);
+}
+
+
+void TileChunk::overlay(Offset offset, std::uint8_t overlay)
+{
+	if (!materialized() && overlay == NoOverlay) { return; }
+	materialize();
+	mOwnPlanes->overlay[offset] = overlay;
+}
+
+
+void TileChunk::slot(Offset offset, Slot slot)
+{
+	if (!materialized() && slot == TileStorage::NoSlot) { return; }
+	materialize();
+	mOwnPlanes->occupancy[offset] = slot;
+}
+
+
+Tile& TileChunk::tile(Offset offset)
+{
+	const auto width = static_cast<Offset>(mStorage.levelSize().x);
+	return row(static_cast<int>(offset / width))[offset % width];
+}
+
+
+std::span<Tile> TileChunk::row(int row)
+{
+	auto& tiles = mRows[static_cast<std::size_t>(row)];
+	if (tiles.empty()) { createRow(row); }
+	return tiles;
+}
+
+
+/**
+ * Picks up new heightmap terrain. A chunk without planes of its own reads
+ * it in place, one with its own terrain has the new terrain copied over it.
+ */
+void TileChunk::heightmapTerrainChanged()
+{
+	const auto* heightmapTerrain = mStorage.terrain().data() + static_cast<std::size_t>(mFirstRow * mStorage.levelSize().x);
+	if (!materialized())
+	{
+		mTerrain = heightmapTerrain;
+		return;
+	}
+
+	std::copy(heightmapTerrain, heightmapTerrain + mTileCount, mOwnPlanes->terrain.begin());
+}
+
+
+void TileChunk::clearConnected()
+{
+	if (materialized()) { mOwnPlanes->connected.fill(false); }
+}
+
+
+void TileChunk::clearOverlays()
+{
+	if (materialized()) { std::fill(mOwnPlanes->overlay.begin(), mOwnPlanes->overlay.end(), NoOverlay); }
+}
+
+
+void TileChunk::createRow(int row)
+{
+	const auto width = static_cast<Offset>(mStorage.levelSize().x);
+	auto& tiles = mRows[static_cast<std::size_t>(row)];
+	tiles.reserve(width);
+	for (Offset offset = static_cast<Offset>(row) * width; tiles.size() < width; ++offset)
+	{
+		tiles.emplace_back(*this, offset);
+	}
+}
+
+
+TileStorage::TileStorage(NAS2D::Vector<int> levelSize, int levelCount) :
+	mLevelSize{levelSize},
+	mLevelCount{levelCount},
+	mChunksPerLevel{(levelSize.y + ChunkRows - 1) / ChunkRows},
+	mTerrain(static_cast<std::size_t>(levelSize.x) * static_cast<std::size_t>(levelSize.y), TerrainType::Dozed),
+	mUnexcavatedPlanes{static_cast<std::size_t>(ChunkRows * levelSize.x), false, NoOverlay}
+{
+	if (levelSize.x <= 0 || levelSize.y <= 0 || levelCount <= 0)
+	{
+		throw std::runtime_error("TileStorage: Map must have at least one tile");
+	}
+
+	mChunks.reserve(static_cast<std::size_t>(mChunksPerLevel * levelCount));
+	for (int level = 0; level < levelCount; ++level)
+	{
+		for (int firstRow = 0; firstRow < levelSize.y; firstRow += ChunkRows)
+		{
+			auto& chunk = *mChunks.emplace_back(std::make_unique<TileChunk>(*this, level, firstRow, std::min(ChunkRows, levelSize.y - firstRow)));
+
+			// The surface is always fully in use
+			if (level == 0) { chunk.materialize(); }
+		}
+	}
+}
+
+
+TileStorage::~TileStorage()
+{
+	for (auto& occupant : mOccupants)
+	{
+		delete occupant.mine;
+		delete occupant.thing;
+	}
+}
+
+
+/**
+ * Replaces the heightmap terrain, which every chunk starts from. Chunks
+ * that are already materialized are reset to it.
+ */
+void TileStorage::terrain(std::vector<TerrainType> terrain)
+{
+	if (terrain.size() != mTerrain.size())
+	{
+		throw std::runtime_error("TileStorage: Terrain has " + std::to_string(terrain.size()) + " tiles, expected " + std::to_string(mTerrain.size()));
+	}
+
+	mTerrain = std::move(terrain);
+	for (auto& chunk : mChunks)
+	{
+		chunk->heightmapTerrainChanged();
+	}
+}
+
+
+Tile& TileStorage::tile(const MapCoordinate& position)
+{
+	return chunkAt(position.z, position.xy.y).row(position.xy.y % ChunkRows)[static_cast<std::size_t>(position.xy.x)];
+}
+
+
+std::span<Tile> TileStorage::row(int level, int y)
+{
+	return chunkAt(level, y).row(y % ChunkRows);
+}
+
+
+std::size_t TileStorage::materializedChunkCount() const
+{
+	return static_cast<std::size_t>(std::count_if(mChunks.begin(), mChunks.end(), [](const auto& chunk) { return chunk->materialized(); }));
+}
+
+
+void TileStorage::clearConnected()
+{
+	for (auto& chunk : mChunks)
+	{
+		chunk->clearConnected();
+	}
+}
+
+
+void TileStorage::clearOverlays()
+{
+	for (auto& chunk : mChunks)
+	{
+		chunk->clearOverlays();
+	}
+}
+
+
+/**
+ * Sets the Thing on a tile without deleting any Thing already there.
+ */
+void TileStorage::thing(TileChunk& chunk, TileChunk::Offset offset, Thing* thing)
+{
+	if (!thing && chunk.slot(offset) == NoSlot) { return; }
+
+	occupant(chunk, offset).thing = thing;
+	releaseIfEmpty(chunk, offset);
+}
+
+
+/**
+ * Sets the Mine on a tile without deleting any Mine already there.
+ */
+void TileStorage::mine(TileChunk& chunk, TileChunk::Offset offset, Mine* mine)
+{
+	if (!mine && chunk.slot(offset) == NoSlot) { return; }
+
+	occupant(chunk, offset).mine = mine;
+	releaseIfEmpty(chunk, offset);
+}
+
+
+/**
+ * The occupancy slot of a tile, taking a free one if the tile doesn't
+ * have one yet.
+ */
+TileStorage::Occupant& TileStorage::occupant(TileChunk& chunk, TileChunk::Offset offset)
+{
+	auto slot = chunk.slot(offset);
+	if (slot == NoSlot)
+	{
+		if (!mFreeSlots.empty())
+		{
+			slot = mFreeSlots.back();
+			mFreeSlots.pop_back();
+		}
+		else
+		{
+			if (mOccupants.size() > std::numeric_limits<Slot>::max())
+			{
+				throw std::runtime_error("TileStorage: Out of occupancy slots");
+			}
+			slot = static_cast<Slot>(mOccupants.size());
+			mOccupants.emplace_back();
+		}
+		chunk.slot(offset, slot);
+	}
+
+	return mOccupants[slot];
+}
+
+
+void TileStorage::releaseIfEmpty(TileChunk& chunk, TileChunk::Offset offset)
+{
+	const auto slot = chunk.slot(offset);
+	const auto& occupant = mOccupants[slot];
+	if (slot == NoSlot || occupant.thing || occupant.mine) { return; }
+
+	mFreeSlots.push_back(slot);
+	chunk.slot(offset, NoSlot);
+}
@@ -0,0 +1,231 @@
+#pragma once
+
+#include "../Common.h"
+
+#include "MapCoordinate.h"
+
+#include <NAS2D/Math/Point.h>
+#include <NAS2D/Math/Vector.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+
+class Mine;
+class Thing;
+class Tile;
+class TileStorage;
+
+
+/**
+ * One bit per tile, packed into words so whole planes can be cleared or
+ * scanned a word at a time.
+ */
+class BitPlane
+{
+public:
+	using Word = std::uint64_t;
+	static constexpr std::size_t WordBits = 64;
+
+	BitPlane() = default;
+	BitPlane(std::size_t bitCount, bool value) :
+		mWords((bitCount + WordBits - 1) / WordBits, value ? ~Word{0} : Word{0})
+	{}
+
+	bool test(std::size_t index) const { return (mWords[index / WordBits] >> (index % WordBits)) & 1; }
+
+	void set(std::size_t index, bool value)
+	{
+		const auto mask = Word{1} << (index % WordBits);
+		auto& word = mWords[index / WordBits];
+		word = value ? (word | mask) : (word & ~mask);
+	}
+
+	void fill(bool value) { std::fill(mWords.begin(), mWords.end(), value ? ~Word{0} : Word{0}); }
+
+	const std::vector<Word>& words() const { return mWords; }
+
+private:
+	std::vector<Word> mWords;
+};
+
+
+/**
+ * Packed tile state for a band of full rows on one level of a TileMap.
+ *
+ * Each kind of state is kept in its own plane so passes that only look at
+ * one kind of state read contiguous memory. Terrain and overlays take a
+ * byte per tile, excavated and connected a bit per tile and occupancy a
+ * slot index per tile.
+ *
+ * Underground chunks start out unmaterialized. They have no planes of
+ * their own and read the TileStorage's shared unexcavated planes, with
+ * terrain read from the heightmap terrain. A chunk gets its own planes the
+ * first time anything in it changes, which in practice is when a digger,
+ * mine shaft or air shaft excavates into it. Tile handles for a row of a
+ * chunk are only made the first time one of its tiles is asked for.
+ */
+class TileChunk
+{
+public:
+	using Offset = std::uint32_t;
+	using Slot = std::uint32_t;
+
+	struct Planes
+	{
+		Planes(std::size_t tileCount, bool isExcavated, std::uint8_t noOverlay);
+
+		std::vector<TerrainType> terrain;
+		std::vector<std::uint8_t> overlay;
+		BitPlane excavated;
+		BitPlane connected;
+		std::vector<Slot> occupancy;
+	};
+
+public:
+	TileChunk(TileStorage& storage, int level, int firstRow, int rowCount);
+	TileChunk(const TileChunk&) = delete;
+	TileChunk& operator=(const TileChunk&) = delete;
+	~TileChunk();
+
+	TileStorage& storage() { return mStorage; }
+
+	int level() const { return mLevel; }
+	int firstRow() const { return mFirstRow; }
+	int rowCount() const { return mRowCount; }
+	Offset tileCount() const { return mTileCount; }
+
+	MapCoordinate positionOf(Offset offset) const;
+
+	bool materialized() const { return mOwnPlanes != nullptr; }
+	void materialize();
+
+	TerrainType terrain(Offset offset) const { return mTerrain[offset]; }
+	void terrain(Offset offset, TerrainType terrain);
+
+	bool excavated(Offset offset) const { return mPlanes->excavated.test(offset); }
+	void excavated(Offset offset, bool value);
+
+	bool connected(Offset offset) const { return mPlanes->connected.test(offset); }
+	void connected(Offset offset, bool value);
+
+	std::uint8_t overlay(Offset offset) const { return mPlanes->overlay[offset]; }
+	void overlay(Offset offset, std::uint8_t overlay);
+
+	Slot slot(Offset offset) const { return mPlanes->occupancy[offset]; }
+	void slot(Offset offset, Slot slot);
+
+	Thing* thing(Offset offset) const;
+	Mine* mine(Offset offset) const;
+
+	Tile& tile(Offset offset);
+	std::span<Tile> row(int row);
+
+	void heightmapTerrainChanged();
+	void clearConnected();
+	void clearOverlays();
+
+private:
+	void createRow(int row);
+
+	TileStorage& mStorage;
+	const int mLevel;
+	const int mFirstRow;
+	const int mRowCount;
+	const Offset mTileCount;
+
+	const TerrainType* mTerrain; /**< Heightmap terrain until materialized, then the chunk's own. */
+	const Planes* mPlanes; /**< Shared unexcavated planes until materialized, then the chunk's own. */
+	std::unique_ptr<Planes> mOwnPlanes;
+
+	std::vector<std::vector<Tile>> mRows; /**< Tile handles by row, empty until asked for. */
+};
+
+
+/**
+ * Packed tile state for every level of a TileMap, kept in TileChunks of
+ * ChunkRows full rows each.
+ *
+ * Tiles holding a Thing or a Mine get an occupancy slot, an index into a
+ * table of those pointers; every other tile's slot is NoSlot.
+ */
+class TileStorage
+{
+public:
+	using Slot = TileChunk::Slot;
+
+	static constexpr Slot NoSlot = 0;
+	static constexpr int ChunkRows = 16;
+
+	struct Occupant
+	{
+		Thing* thing{nullptr};
+		Mine* mine{nullptr};
+	};
+
+public:
+	TileStorage(NAS2D::Vector<int> levelSize, int levelCount);
+	TileStorage(const TileStorage&) = delete;
+	TileStorage& operator=(const TileStorage&) = delete;
+	~TileStorage();
+
+	NAS2D::Vector<int> levelSize() const { return mLevelSize; }
+	int levelCount() const { return mLevelCount; }
+	std::size_t levelTileCount() const { return mTerrain.size(); }
+
+	const std::vector<TerrainType>& terrain() const { return mTerrain; }
+	void terrain(std::vector<TerrainType> terrain);
+
+	Tile& tile(const MapCoordinate& position);
+	std::span<Tile> row(int level, int y);
+
+	std::size_t chunkCount() const { return mChunks.size(); }
+	const TileChunk& chunk(std::size_t index) const { return *mChunks[index]; }
+	std::size_t materializedChunkCount() const;
+
+	void clearConnected();
+	void clearOverlays();
+
+	const Occupant& occupant(Slot slot) const { return mOccupants[slot]; }
+	void thing(TileChunk& chunk, TileChunk::Offset offset, Thing* thing);
+	void mine(TileChunk& chunk, TileChunk::Offset offset, Mine* mine);
+
+	const TileChunk::Planes& unexcavatedPlanes() const { return mUnexcavatedPlanes; }
+
+	const TileChunk& chunkAt(int level, int y) const { return *mChunks[chunkIndex(level, y)]; }
+	TileChunk::Offset offsetOf(NAS2D::Point<int> position) const { return static_cast<TileChunk::Offset>((position.y % ChunkRows) * mLevelSize.x + position.x); }
+
+private:
+	std::size_t chunkIndex(int level, int y) const { return static_cast<std::size_t>(level * mChunksPerLevel + y / ChunkRows); }
+	TileChunk& chunkAt(int level, int y) { return *mChunks[chunkIndex(level, y)]; }
+
+	Occupant& occupant(TileChunk& chunk, TileChunk::Offset offset);
+	void releaseIfEmpty(TileChunk& chunk, TileChunk::Offset offset);
+
+	const NAS2D::Vector<int> mLevelSize;
+	const int mLevelCount;
+	const int mChunksPerLevel;
+
+	std::vector<TerrainType> mTerrain; /**< Terrain from the heightmap, one level's worth. */
+	const TileChunk::Planes mUnexcavatedPlanes;
+	std::vector<std::unique_ptr<TileChunk>> mChunks;
+
+	std::vector<Occupant> mOccupants{1}; /**< Slot NoSlot is always empty, so empty tiles read null pointers. */
+	std::vector<Slot> mFreeSlots;
+};
+
+
+inline Thing* TileChunk::thing(Offset offset) const
+{
+	return mStorage.occupant(slot(offset)).thing;
+}
+
+
+inline Mine* TileChunk::mine(Offset offset) const
+{
+	return mStorage.occupant(slot(offset)).mine;
+}
@@ -1032,6 +1032,14 @@ int MicroPather::SolveForNearStates(void* startState, std::vector< StateCost >*
 
 		for (std::size_t i = 0; i < node->numAdjacent; ++i)
 		{
+			// OPHD local modification, not in upstream MicroPather: filter out infinite
+			// cost as Solve() does. The open queue can't sort it in ahead of its sentinel,
+			// so SolveForNearStates never finished on maps with impassable tiles.
+			if (nodeCostVec[i].cost == FLT_MAX)
+			{
+				continue;
+			}
+
 			MPASSERT(node->costFromStart < FLT_MAX);
 			float newCost = node->costFromStart + nodeCostVec[i].cost;
 
@@ -27,7 +27,8 @@ distribution.
 
 /**
  * This is a slightly modified version of MicroPather -- it removes non-stl implementations
- * and implements minor improvements using C++17 updates.
+ * and implements minor improvements using C++17 updates. SolveForNearStates() also skips
+ * infinite cost neighbours; that change is marked "OPHD local modification" in the source.
  */
 
 /** @mainpage MicroPather
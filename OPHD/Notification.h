@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Map/MapCoordinate.h"
+
+#include <string>
+
+
+enum class NotificationType
+{
+	Critical,
+	Information,
+	Warning
+};
+
+
+/**
+ * Message raised by the simulation for the player, shown by the
+ * NotificationArea.
+ */
+struct Notification
+{
+	std::string brief{""};
+	std::string message{""};
+	MapCoordinate position{{-1, -1}, 0};
+	NotificationType type{NotificationType::Information};
+};
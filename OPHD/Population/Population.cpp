@@ -81,7 +81,7 @@ void Population::spawnPopulation(int morale, int residences, int nurseries, int
 	for (int toRetire = newRoles.retiree; toRetire > 0;)
 	{
 		/** Workers retire earlier than scientists. */
-		auto& retireRole = randomNumber.generate(0, 100) <= 45 ?
+		auto& retireRole = randomStreams[RandomStream::PopulationRetirement].generate(0, 100) <= 45 ?
 			mPopulation.scientist : mPopulation.worker;
 		if (retireRole > 0)
 		{
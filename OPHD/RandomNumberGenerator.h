@@ -1,14 +1,48 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <type_traits>
 #include <stdexcept>
 #include <random>
 
 
+/**
+ * Counter based random number generator.
+ *
+ * Each value is a hash of the seed, the stream id and the number of values
+ * drawn so far, so a stream's output depends only on those three numbers.
+ * Two streams sharing a seed never interfere with each other and a stream
+ * can be restored exactly by restoring its counter.
+ *
+ * Integer and floating point ranges are mapped by this class rather than by
+ * the standard distributions, whose output differs between standard library
+ * implementations, so sequences are identical on every platform.
+ */
 class RandomNumberGenerator
 {
 public:
-	RandomNumberGenerator() : generator(randomDevice()) {};
+	RandomNumberGenerator() = default;
+	explicit RandomNumberGenerator(std::uint64_t seed, std::uint64_t stream = 0) : mSeed(seed), mStream(stream) {}
+
+	void seed(std::uint64_t seed)
+	{
+		mSeed = seed;
+		mCounter = 0;
+	}
+
+	std::uint64_t seed() const { return mSeed; }
+	std::uint64_t stream() const { return mStream; }
+
+	void counter(std::uint64_t counter) { mCounter = counter; }
+	std::uint64_t counter() const { return mCounter; }
+
+	std::uint64_t next()
+	{
+		return mix(mix(mSeed ^ mix(mStream + 0x9E3779B97F4A7C15)) + mCounter++);
+	}
 
 	template <typename T>
 	std::enable_if_t<std::is_arithmetic_v<T>, T>
@@ -21,13 +55,27 @@ public:
 
 		if constexpr (std::is_integral_v<T>)
 		{
-			std::uniform_int_distribution<T> distribution(min, max);
-			return distribution(generator);
+			using Unsigned = std::make_unsigned_t<T>;
+			const auto range = static_cast<std::uint64_t>(static_cast<Unsigned>(static_cast<Unsigned>(max) - static_cast<Unsigned>(min)));
+			if (range == std::numeric_limits<std::uint64_t>::max())
+			{
+				return static_cast<T>(next());
+			}
+
+			// Reject values from the incomplete last bucket so every result is equally likely
+			const auto buckets = range + 1;
+			const auto limit = std::numeric_limits<std::uint64_t>::max() - std::numeric_limits<std::uint64_t>::max() % buckets;
+			auto value = next();
+			while (value >= limit)
+			{
+				value = next();
+			}
+			return static_cast<T>(static_cast<Unsigned>(static_cast<Unsigned>(min) + static_cast<Unsigned>(value % buckets)));
 		}
 		else if constexpr (std::is_floating_point_v<T>)
 		{
-			std::uniform_real_distribution<T> distribution(min, max);
-			return distribution(generator);
+			const auto unit = static_cast<T>(static_cast<double>(next() >> 11) * 0x1.0p-53);
+			return min + (max - min) * unit;
 		}
 		else
 		{
@@ -36,8 +84,77 @@ public:
 	}
 
 private:
-	std::random_device randomDevice;
-	std::mt19937 generator;
+	/** SplitMix64 finalizer. */
+	static constexpr std::uint64_t mix(std::uint64_t value)
+	{
+		value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+		value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+		return value ^ (value >> 31);
+	}
+
+	std::uint64_t mSeed{0};
+	std::uint64_t mStream{0};
+	std::uint64_t mCounter{0};
+};
+
+
+/**
+ * Subsystems that draw from their own random stream.
+ */
+enum class RandomStream
+{
+	General,
+	PopulationRetirement,
+	CrimeRate,
+	CrimeExecution,
+	MinePlacement,
+
+	Count
+};
+
+
+/**
+ * One RandomNumberGenerator per RandomStream, all derived from a single seed.
+ */
+class RandomStreams
+{
+public:
+	static constexpr std::size_t StreamCount = static_cast<std::size_t>(RandomStream::Count);
+
+	RandomStreams() : RandomStreams(newSeed()) {}
+	explicit RandomStreams(std::uint64_t seed) { this->seed(seed); }
+
+	/**
+	 * A nondeterministic seed for starting a new game.
+	 */
+	static std::uint64_t newSeed()
+	{
+		std::random_device randomDevice;
+		return (static_cast<std::uint64_t>(randomDevice()) << 32) ^ static_cast<std::uint64_t>(randomDevice());
+	}
+
+	/**
+	 * Reseeds every stream and resets its counter.
+	 */
+	void seed(std::uint64_t seed)
+	{
+		mSeed = seed;
+		for (std::size_t i = 0; i < StreamCount; ++i)
+		{
+			mStreams[i] = RandomNumberGenerator{seed, i};
+		}
+	}
+
+	std::uint64_t seed() const { return mSeed; }
+
+	RandomNumberGenerator& operator[](RandomStream stream) { return mStreams[static_cast<std::size_t>(stream)]; }
+	const RandomNumberGenerator& operator[](RandomStream stream) const { return mStreams[static_cast<std::size_t>(stream)]; }
+
+private:
+	std::uint64_t mSeed{0};
+	std::array<RandomNumberGenerator, StreamCount> mStreams;
 };
 
-inline RandomNumberGenerator randomNumber;
+
+inline RandomStreams randomStreams;
+inline RandomNumberGenerator& randomNumber = randomStreams[RandomStream::General];
@@ -0,0 +1,116 @@
+#include "RefinedResourceLedger.h"
+
+#include "Things/Structures/Structure.h"
+
+#include <algorithm>
+
+
+/**
+ * Adds refined resources to storage.
+ *
+ * \return	Resources that did not fit.
+ */
+StorableResources RefinedResourceLedger::add(StorableResources resourcesToAdd)
+{
+	for (auto structure : mStorage)
+	{
+		if (resourcesToAdd.isEmpty()) { break; }
+
+		auto& storedResources = structure->storage();
+
+		const auto newResources = storedResources + resourcesToAdd;
+		const auto capped = newResources.cap(structure->storageCapacity() / 4);
+
+		mStored += capped - storedResources;
+		storedResources = capped;
+		resourcesToAdd = newResources - capped;
+	}
+
+	return resourcesToAdd;
+}
+
+
+/**
+ * Removes refined resources from storage. Anything that could not be
+ * removed is left in \c resourcesToRemove.
+ */
+void RefinedResourceLedger::remove(StorableResources& resourcesToRemove)
+{
+	const auto removeFrom = [this, &resourcesToRemove](Structure& structure)
+	{
+		auto& storedResources = structure.storage();
+		const auto toTransfer = resourcesToRemove.cap(storedResources);
+		storedResources -= toTransfer;
+		resourcesToRemove -= toTransfer;
+		mStored -= toTransfer;
+	};
+
+	for (std::size_t i = mCommandCenterCount; i < mStorage.size() && !resourcesToRemove.isEmpty(); ++i)
+	{
+		removeFrom(*mStorage[i]);
+	}
+
+	for (std::size_t i = 0; i < mCommandCenterCount && !resourcesToRemove.isEmpty(); ++i)
+	{
+		removeFrom(*mStorage[i]);
+	}
+}
+
+
+/**
+ * Rebuilds the running total from the storage structures.
+ */
+void RefinedResourceLedger::recount()
+{
+	mStored = {};
+	for (const auto structure : mStorage)
+	{
+		mStored += structure->storage();
+	}
+}
+
+
+bool RefinedResourceLedger::isStorage(const Structure& structure)
+{
+	return structure.structureClass() == Structure::StructureClass::Command ||
+		structure.structureClass() == Structure::StructureClass::Storage;
+}
+
+
+void RefinedResourceLedger::addStorage(Structure& structure)
+{
+	if (!isStorage(structure)) { return; }
+
+	if (structure.structureClass() == Structure::StructureClass::Command)
+	{
+		mStorage.insert(mStorage.begin() + static_cast<std::ptrdiff_t>(mCommandCenterCount), &structure);
+		++mCommandCenterCount;
+	}
+	else
+	{
+		mStorage.push_back(&structure);
+	}
+
+	mStored += structure.storage();
+}
+
+
+void RefinedResourceLedger::removeStorage(Structure& structure)
+{
+	const auto it = std::find(mStorage.begin(), mStorage.end(), &structure);
+	if (it == mStorage.end()) { return; }
+
+	if (static_cast<std::size_t>(it - mStorage.begin()) < mCommandCenterCount)
+	{
+		--mCommandCenterCount;
+	}
+	mStorage.erase(it);
+
+	mStored -= structure.storage();
+}
+
+
+void RefinedResourceLedger::clear()
+{
+	*this = RefinedResourceLedger{};
+}
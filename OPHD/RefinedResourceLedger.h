@@ -0,0 +1,53 @@
+#pragma once
+
+#include "StorableResources.h"
+
+#include <cstddef>
+#include <vector>
+
+
+class Structure;
+
+
+/**
+ * Colony wide account of refined resources held in storage structures.
+ *
+ * Command Centers and Storage Tanks register with the ledger as they are
+ * added to the StructureManager. The ledger keeps a running total of what
+ * they hold so checking what the colony can afford never needs to visit
+ * the storage structures.
+ *
+ * Adds fill Command Centers first and removes drain them last, as the
+ * Command Center is backup storage for the early game.
+ *
+ * \note	Code that changes a storage structure's contents directly instead
+ *			of going through add() and remove() must report the change with
+ *			credited() or debited(), or call recount() afterward.
+ */
+class RefinedResourceLedger
+{
+public:
+	const StorableResources& stored() const { return mStored; }
+
+	StorableResources add(StorableResources resourcesToAdd);
+	void remove(StorableResources& resourcesToRemove);
+
+	void credited(const StorableResources& resources) { mStored += resources; }
+	void debited(const StorableResources& resources) { mStored -= resources; }
+
+	void recount();
+
+private:
+	friend class StructureManager;
+
+	static bool isStorage(const Structure& structure);
+
+	void addStorage(Structure& structure);
+	void removeStorage(Structure& structure);
+	void clear();
+
+	std::vector<Structure*> mStorage; /**< Command Centers followed by Storage Tanks. */
+	std::size_t mCommandCenterCount{0};
+
+	StorableResources mStored;
+};
@@ -0,0 +1,519 @@
+#include "ColonySimulation.h"
+
+#include "MapViewStateHelper.h"
+#include "LogisticsTable.h"
+
+#include "../DirectionOffset.h"
+#include "../StructureCatalogue.h"
+#include "../StructureManager.h"
+
+#include "../Map/Tile.h"
+#include "../Map/TileMap.h"
+
+#include "../Things/Robots/Robots.h"
+
+#include <NAS2D/Utility.h>
+
+#include <algorithm>
+#include <array>
+#include <span>
+#include <stdexcept>
+
+
+namespace
+{
+	// Relative proportion of mines with yields {low, med, high}
+	const std::map<Planet::Hostility, std::array<int, 3>> HostilityMineYields =
+	{
+		{Planet::Hostility::Low, {30, 50, 20}},
+		{Planet::Hostility::Medium, {45, 35, 20}},
+		{Planet::Hostility::High, {35, 20, 45}},
+	};
+
+
+	template <typename StructureType>
+	void addCoverageSources(std::vector<CoverageGrid::Source>& sources, std::span<StructureType* const> structures)
+	{
+		for (auto structure : structures)
+		{
+			if (!structure->operational()) { continue; }
+			sources.push_back({structure->tile()->xyz(), structure->getRange()});
+		}
+	}
+}
+
+
+/**
+ * Creates an empty simulation. Used when the colony is going to be
+ * restored from a savegame with load().
+ */
+ColonySimulation::ColonySimulation() :
+	mCrimeExecution(mNotificationSignal)
+{
+	ccLocation() = CcNotPlaced;
+	mPopulationPool.population(&mPopulation);
+
+	auto& structureManager = NAS2D::Utility<StructureManager>::get();
+	structureManager.structureAdded().connect(this, &ColonySimulation::tileRouteCostChanged);
+	structureManager.structureRemoved().connect(this, &ColonySimulation::onStructureRemoved);
+}
+
+
+ColonySimulation::ColonySimulation(const Planet::Attributes& planetAttributes, Difficulty selectedDifficulty, std::uint64_t randomSeed) :
+	mPlanetAttributes(planetAttributes),
+	mCrimeExecution(mNotificationSignal)
+{
+	// Seed before the TileMap is built so mine placement is reproducible
+	randomStreams.seed(randomSeed);
+
+	mTileMap = new TileMap(planetAttributes.mapImagePath, planetAttributes.maxDepth, planetAttributes.maxMines, HostilityMineYields.at(planetAttributes.hostility));
+	mConnectivityIndex = std::make_unique<ConnectivityIndex>(*mTileMap);
+	mOreLogistics = std::make_unique<OreLogisticsPlanner>(*mTileMap);
+
+	difficulty(selectedDifficulty);
+	ccLocation() = CcNotPlaced;
+	mPopulationPool.population(&mPopulation);
+
+	auto& structureManager = NAS2D::Utility<StructureManager>::get();
+	structureManager.structureAdded().connect(this, &ColonySimulation::tileRouteCostChanged);
+	structureManager.structureRemoved().connect(this, &ColonySimulation::onStructureRemoved);
+
+	// StructureCatalogue is initialized in load routine if saved game present to load existing structures
+	StructureCatalogue::init(mPlanetAttributes.meanSolarDistance);
+
+	resetCoverage();
+}
+
+
+ColonySimulation::~ColonySimulation()
+{
+	auto& structureManager = NAS2D::Utility<StructureManager>::get();
+	structureManager.structureAdded().disconnect(this, &ColonySimulation::tileRouteCostChanged);
+	structureManager.structureRemoved().disconnect(this, &ColonySimulation::onStructureRemoved);
+
+	scrubRobotList();
+	mConnectivityIndex.reset();
+	mOreLogistics.reset();
+	delete mTileMap;
+
+	NAS2D::Utility<LogisticsTable>::get().clear();
+}
+
+
+void ColonySimulation::difficulty(Difficulty difficulty)
+{
+	mDifficulty = difficulty;
+	mCrimeRateUpdate.difficulty(difficulty);
+	mCrimeExecution.difficulty(difficulty);
+}
+
+
+Robot& ColonySimulation::addRobot(Robot::Type type)
+{
+	auto& robot = mRobotPool.addRobot(type);
+
+	if (type == Robot::Type::Digger)
+	{
+		robot.taskComplete().connect(this, &ColonySimulation::onDiggerTaskComplete);
+	}
+	else if (type == Robot::Type::Miner)
+	{
+		robot.taskComplete().connect(this, &ColonySimulation::onMinerTaskComplete);
+	}
+
+	return robot;
+}
+
+
+void ColonySimulation::insertTube(ConnectorDir dir, int depth, Tile& tile)
+{
+	if (dir == ConnectorDir::CONNECTOR_VERTICAL)
+	{
+		throw std::runtime_error("ColonySimulation::insertTube() called with invalid ConnectorDir paramter.");
+	}
+
+	NAS2D::Utility<StructureManager>::get().addStructure(*new Tube(dir, depth != 0), tile);
+}
+
+
+/**
+ * Puts a robot to work on a tile. The robot blocks trucks
+ * until it leaves, so routes over the tile are dropped.
+ */
+void ColonySimulation::deployRobot(Robot& robot, Tile& tile)
+{
+	mRobotPool.insertRobotIntoTable(mRobotList, robot, tile);
+	tileRouteCostChanged(tile);
+}
+
+
+/**
+ * Bulldozes a tile's terrain. Truck routes crossing the tile are dropped
+ * since it changes what it costs to drive over it.
+ */
+void ColonySimulation::dozeTile(Tile& tile)
+{
+	tile.index(TerrainType::Dozed);
+	tileRouteCostChanged(tile);
+}
+
+
+/**
+ * Called for anything that changes what a truck pays to drive over a
+ * tile, including structures being added to or removed from it.
+ */
+void ColonySimulation::tileRouteCostChanged(Tile& tile)
+{
+	if (mTileMap)
+	{
+		mTileMap->invalidateRouteCost(tile);
+	}
+	if (mOreLogistics && tile.depth() == 0)
+	{
+		mOreLogistics->invalidate(tile.xy());
+	}
+	if (mTileMap && tile.depth() == 0)
+	{
+		NAS2D::Utility<LogisticsTable>::get().invalidate(Route::indexOf(tile.xy(), mTileMap->size().x));
+	}
+}
+
+
+/**
+ * Clears a robot that finished or broke down off its tile, letting
+ * trucks through again.
+ */
+void ColonySimulation::takeRobotOffTile(Robot& robot, Tile& tile)
+{
+	if (tile.thing() == &robot)
+	{
+		tile.removeThing();
+		tileRouteCostChanged(tile);
+	}
+}
+
+
+/**
+ * Called after a structure has been taken out of the StructureManager's
+ * lists but before it's taken off its tile. Coverage is rebuilt here so
+ * a demolished Comm Tower or police station stops covering its range
+ * straight away instead of at the next turn. A smelter's ore field is
+ * dropped along with it.
+ */
+void ColonySimulation::onStructureRemoved(Tile& tile)
+{
+	tileRouteCostChanged(tile);
+
+	const auto* structure = tile.structure();
+	if (!structure) { return; }
+
+	const auto structureClass = structure->structureClass();
+	if (structureClass == Structure::StructureClass::Smelter && mOreLogistics)
+	{
+		mOreLogistics->remove(dynamic_cast<const OreRefining&>(*structure));
+	}
+	else if (structureClass == Structure::StructureClass::Command || structureClass == Structure::StructureClass::Communication)
+	{
+		updateCommRangeOverlay();
+	}
+	else if (structureClass == Structure::StructureClass::SurfacePolice || structureClass == Structure::StructureClass::UndergroundPolice)
+	{
+		updatePoliceOverlay();
+	}
+}
+
+
+/**
+ * Brings connectedness to the Command Center up to date. Cheap unless
+ * a connected structure has been removed since the last call.
+ */
+void ColonySimulation::updateConnectedness()
+{
+	if (mConnectivityIndex)
+	{
+		mConnectivityIndex->update();
+	}
+}
+
+
+const std::vector<Tile*>& ColonySimulation::connectednessOverlay() const
+{
+	static const std::vector<Tile*> noConnectedTiles;
+	return mConnectivityIndex ? mConnectivityIndex->connectedTiles() : noConnectedTiles;
+}
+
+
+void ColonySimulation::updateCommRangeOverlay()
+{
+	auto& structureManager = NAS2D::Utility<StructureManager>::get();
+
+	std::vector<CoverageGrid::Source> sources;
+	addCoverageSources(sources, structureManager.getStructures<CommandCenter>());
+	addCoverageSources(sources, structureManager.getStructures<CommTower>());
+	mCommRangeCoverage.update(std::move(sources));
+}
+
+
+void ColonySimulation::updatePoliceOverlay()
+{
+	auto& structureManager = NAS2D::Utility<StructureManager>::get();
+
+	std::vector<CoverageGrid::Source> sources;
+	addCoverageSources(sources, structureManager.getStructures<SurfacePolice>());
+	addCoverageSources(sources, structureManager.getStructures<UndergroundPolice>());
+	mPoliceCoverage.update(std::move(sources));
+}
+
+
+/**
+ * Communications only reach across the surface while police
+ * coverage exists at every depth.
+ */
+void ColonySimulation::resetCoverage()
+{
+	mCommRangeCoverage = CoverageGrid{*mTileMap, 1};
+	mPoliceCoverage = CoverageGrid{*mTileMap, mTileMap->maxDepth() + 1};
+}
+
+
+void ColonySimulation::updatePlayerResources()
+{
+	mResourcesCount = NAS2D::Utility<StructureManager>::get().refinedResources().stored();
+}
+
+
+/**
+ * Removes deployed robots from the TileMap to
+ * prevent dangling pointers. Yay for raw memory!
+ */
+void ColonySimulation::scrubRobotList()
+{
+	for (auto it : mRobotList)
+	{
+		it.second->removeThing();
+	}
+}
+
+
+void ColonySimulation::pullRobotFromFactory(ProductType productType, Factory& factory)
+{
+	const std::map<ProductType, Robot::Type> ProductTypeToRobotType
+	{
+		{ProductType::PRODUCT_DIGGER, Robot::Type::Digger},
+		{ProductType::PRODUCT_DOZER, Robot::Type::Dozer},
+		{ProductType::PRODUCT_MINER, Robot::Type::Miner},
+	};
+
+	if (ProductTypeToRobotType.find(productType) == ProductTypeToRobotType.end())
+	{
+		throw std::runtime_error("pullRobotFromFactory():: unsuitable ProductType: " + std::to_string(static_cast<int>(productType)));
+	}
+
+	const auto robotType = ProductTypeToRobotType.at(productType);
+	RobotCommand* robotCommand = getAvailableRobotCommand();
+
+	if ((robotCommand != nullptr) || mRobotPool.commandCapacityAvailable())
+	{
+		auto& robot = addRobot(robotType);
+		factory.pullProduct();
+
+		if (robotCommand != nullptr) { robotCommand->addRobot(&robot); }
+	}
+	else
+	{
+		factory.idle(IdleReason::FactoryInsufficientRobotCommandCapacity);
+	}
+}
+
+
+/**
+ * Called whenever a Factory's production is complete.
+ */
+void ColonySimulation::onFactoryProductionComplete(Factory& factory)
+{
+	const auto productType = factory.productWaiting();
+	switch (productType)
+	{
+	case ProductType::PRODUCT_DIGGER:
+	case ProductType::PRODUCT_DOZER:
+	case ProductType::PRODUCT_MINER:
+		pullRobotFromFactory(productType, factory);
+		break;
+
+	case ProductType::PRODUCT_TRUCK:
+	case ProductType::PRODUCT_CLOTHING:
+	case ProductType::PRODUCT_MEDICINE:
+		{
+			Warehouse* warehouse = getAvailableWarehouse(productType, 1);
+			if (warehouse) { warehouse->products().store(productType, 1); factory.pullProduct(); }
+			else { factory.idle(IdleReason::FactoryInsufficientWarehouseSpace); }
+			break;
+		}
+
+	default:
+		throw std::runtime_error("Unknown product completed");
+	}
+}
+
+
+/**
+ * Lands colonists on the surfaces and adds them to the population pool.
+ */
+void ColonySimulation::onDeployColonistLander()
+{
+	mPopulation.addPopulation({0, 10, 20, 20, 0});
+}
+
+
+/**
+ * Lands cargo on the surface and adds resources to the resource pool.
+ */
+void ColonySimulation::onDeployCargoLander()
+{
+	auto cc = static_cast<CommandCenter*>(mTileMap->getTile({ccLocation(), 0}).structure());
+	cc->foodLevel(cc->foodLevel() + 125);
+	const StorableResources cargo{25, 25, 15, 15};
+	cc->storage() += cargo;
+	NAS2D::Utility<StructureManager>::get().refinedResources().credited(cargo);
+}
+
+
+/**
+ * Sets up the initial colony deployment.
+ *
+ * \note	The deploy callback only gets called once so there is really no
+ *			need to disconnect the callback since it will automatically be
+ *			released when the seed lander is destroyed.
+ */
+void ColonySimulation::onDeploySeedLander(NAS2D::Point<int> point)
+{
+	// Bulldoze lander region
+	for (const auto& direction : DirectionScan3x3)
+	{
+		dozeTile(mTileMap->getTile({point + direction, 0}));
+	}
+
+	auto& structureManager = NAS2D::Utility<StructureManager>::get();
+
+	// Place initial tubes
+	for (const auto& direction : DirectionClockwise4)
+	{
+		structureManager.addStructure(*new Tube(ConnectorDir::CONNECTOR_INTERSECTION, false), mTileMap->getTile({point + direction, 0}));
+	}
+
+	// TOP ROW
+	structureManager.addStructure(*new SeedPower(), mTileMap->getTile({point + DirectionNorthWest, 0}));
+
+	auto& cc = *static_cast<CommandCenter*>(StructureCatalogue::get(StructureID::SID_COMMAND_CENTER));
+	cc.sprite().setFrame(3);
+	structureManager.addStructure(cc, mTileMap->getTile({point + DirectionNorthEast, 0}));
+	ccLocation() = point + DirectionNorthEast;
+
+	// BOTTOM ROW
+	auto& sf = *static_cast<SeedFactory*>(StructureCatalogue::get(StructureID::SID_SEED_FACTORY));
+	sf.resourcePool(&mResourcesCount);
+	sf.productionComplete().connect(this, &ColonySimulation::onFactoryProductionComplete);
+	sf.sprite().setFrame(7);
+	structureManager.addStructure(sf, mTileMap->getTile({point + DirectionSouthWest, 0}));
+
+	auto& ss = *static_cast<SeedSmelter*>(StructureCatalogue::get(StructureID::SID_SEED_SMELTER));
+	ss.sprite().setFrame(10);
+	structureManager.addStructure(ss, mTileMap->getTile({point + DirectionSouthEast, 0}));
+
+	// Robots only become available after the SEED Factory is deployed.
+	addRobot(Robot::Type::Dozer);
+	addRobot(Robot::Type::Digger);
+	addRobot(Robot::Type::Miner);
+}
+
+
+/**
+ * Called whenever a RoboDigger completes its task.
+ */
+void ColonySimulation::onDiggerTaskComplete(Robot* robot)
+{
+	if (mRobotList.find(robot) == mRobotList.end())
+	{
+		throw std::runtime_error("ColonySimulation::onDiggerTaskComplete() called with a Robot not in the Robot List!");
+	}
+
+	auto& tile = *mRobotList[robot];
+	const auto position = tile.xyz();
+
+	if (position.z > mTileMap->maxDepth())
+	{
+		throw std::runtime_error("Digger defines a depth that exceeds the maximum digging depth!");
+	}
+
+	const auto dir = static_cast<Robodigger*>(robot)->direction(); // fugly
+	auto newPosition = position;
+	if (dir == Direction::Down) { ++newPosition.z; }
+	newPosition.xy += directionEnumToOffset(dir);
+
+	/**
+	 * Excavated before any structures are placed so the AirShaft on the new
+	 * level can be walked to when connectedness is updated.
+	 *
+	 * \todo	Add checks for obstructions and things that explode if
+	 *			a digger gets in the way (or should diggers be smarter than
+	 *			puncturing a fusion reactor containment vessel?)
+	 */
+	for (const auto& offset : DirectionScan3x3)
+	{
+		mTileMap->getTile({newPosition.xy + offset, newPosition.z}).excavated(true);
+	}
+
+	if (dir == Direction::Down)
+	{
+		auto& as1 = *new AirShaft();
+		if (position.z > 0) { as1.ug(); }
+		NAS2D::Utility<StructureManager>::get().addStructure(as1, tile);
+
+		auto& as2 = *new AirShaft();
+		as2.ug();
+		NAS2D::Utility<StructureManager>::get().addStructure(as2, mTileMap->getTile(newPosition));
+
+		dozeTile(mTileMap->getTile(position));
+		dozeTile(mTileMap->getTile(newPosition));
+
+		updateConnectedness();
+	}
+}
+
+
+/**
+ * Called whenever a RoboMiner completes its task.
+ */
+void ColonySimulation::onMinerTaskComplete(Robot* robot)
+{
+	if (mRobotList.find(robot) == mRobotList.end()) { throw std::runtime_error("ColonySimulation::onMinerTaskComplete() called with a Robot not in the Robot List!"); }
+
+	auto& robotTile = *mRobotList[robot];
+
+	// Surface structure
+	auto& mineFacility = *new MineFacility(robotTile.mine());
+	mineFacility.maxDepth(mTileMap->maxDepth());
+	NAS2D::Utility<StructureManager>::get().addStructure(mineFacility, robotTile);
+	mineFacility.extensionComplete().connect(this, &ColonySimulation::onMineFacilityExtend);
+
+	// Tile immediately underneath facility. Excavated first so the MineShaft
+	// can be walked to when it's added.
+	auto& tileBelow = mTileMap->getTile({robotTile.xy(), robotTile.depth() + 1});
+	tileBelow.excavated(true);
+	NAS2D::Utility<StructureManager>::get().addStructure(*new MineShaft(), tileBelow);
+
+	dozeTile(robotTile);
+	dozeTile(tileBelow);
+
+	robot->die();
+}
+
+
+void ColonySimulation::onMineFacilityExtend(MineFacility* mineFacility)
+{
+	auto& mineFacilityTile = NAS2D::Utility<StructureManager>::get().tileFromStructure(mineFacility);
+	auto& mineDepthTile = mTileMap->getTile({mineFacilityTile.xy(), mineFacility->mine()->depth()});
+	mineDepthTile.excavated(true);
+	NAS2D::Utility<StructureManager>::get().addStructure(*new MineShaft(), mineDepthTile);
+	dozeTile(mineDepthTile);
+}
@@ -0,0 +1,237 @@
+#pragma once
+
+#include "CrimeRateUpdate.h"
+#include "CrimeExecution.h"
+#include "LogisticsTable.h"
+#include "OreLogisticsPlanner.h"
+#include "Planet.h"
+
+#include "../Constants/Numbers.h"
+
+#include "../Common.h"
+#include "../ConnectivityIndex.h"
+#include "../Notification.h"
+#include "../StorableResources.h"
+#include "../RobotPool.h"
+#include "../PopulationPool.h"
+#include "../RandomNumberGenerator.h"
+#include "../TurnProfiler.h"
+#include "../Map/CoverageGrid.h"
+#include "../Population/Population.h"
+
+#include "../Technology/ResearchTracker.h"
+
+#include "../Things/Robots/Robot.h"
+
+#include <NAS2D/Signal/Signal.h>
+#include <NAS2D/Math/Point.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+
+
+namespace NAS2D
+{
+	namespace Xml
+	{
+		class XmlElement;
+	}
+}
+
+class Tile;
+class TileMap;
+class Factory;
+class MineFacility;
+
+using RobotTileTable = std::map<Robot*, Tile*>;
+
+
+/**
+ * Colony state and the rules that advance it from one turn to the next.
+ *
+ * Owns everything a turn touches that isn't presentation: the TileMap, the
+ * resource, robot and population pools, morale and crime. Nothing in here
+ * draws or depends on a UI control so it can be driven by MapViewState or
+ * by a command line tool alike. Anything the player should be told about
+ * is emitted through the notification signal.
+ */
+class ColonySimulation
+{
+public:
+	using MoraleChangeList = std::vector<std::pair<std::string, int>>;
+	using NotificationSignal = NAS2D::Signal<Notification>;
+	using RobotRemovedSignal = NAS2D::Signal<Robot*>;
+
+public:
+	ColonySimulation();
+	ColonySimulation(const Planet::Attributes& planetAttributes, Difficulty selectedDifficulty, std::uint64_t randomSeed = RandomStreams::newSeed());
+	~ColonySimulation();
+
+	void load(NAS2D::Xml::XmlElement* root);
+	NAS2D::Xml::XmlElement* serializeProperties() const;
+	NAS2D::Xml::XmlElement* serializeRandomState() const;
+
+	void nextTurn();
+
+	NotificationSignal::Source& notification() { return mNotificationSignal; }
+	RobotRemovedSignal::Source& robotRemoved() { return mRobotRemovedSignal; }
+
+	const Planet::Attributes& planetAttributes() const { return mPlanetAttributes; }
+
+	std::uint64_t randomSeed() const { return randomStreams.seed(); }
+
+	Difficulty difficulty() const { return mDifficulty; }
+	void difficulty(Difficulty difficulty);
+
+	TileMap* tileMap() { return mTileMap; }
+
+	StorableResources& resources() { return mResourcesCount; }
+	RobotPool& robotPool() { return mRobotPool; }
+	RobotTileTable& robotList() { return mRobotList; }
+	Population& population() { return mPopulation; }
+	ResearchTracker& researchTracker() { return mResearchTracker; }
+
+	const StorableResources& resources() const { return mResourcesCount; }
+	const RobotPool& robotPool() const { return mRobotPool; }
+	const RobotTileTable& robotList() const { return mRobotList; }
+	const Population& population() const { return mPopulation; }
+	const ResearchTracker& researchTracker() const { return mResearchTracker; }
+
+	const int& food() const { return mFood; }
+	const int& morale() const { return mCurrentMorale; }
+	const int& previousMorale() const { return mPreviousMorale; }
+
+	int turnCount() const { return mTurnCount; }
+	int residentialCapacity() const { return mResidentialCapacity; }
+	int meanCrimeRate() const { return mCrimeRateUpdate.meanCrimeRate(); }
+
+	int colonistLanders() const { return mLandersColonist; }
+	void colonistLanders(int count) { mLandersColonist = count; }
+	int cargoLanders() const { return mLandersCargo; }
+	void cargoLanders(int count) { mLandersCargo = count; }
+
+	const MoraleChangeList& moraleChanges() const { return mMoraleChanges; }
+
+	TurnProfiler& turnProfiler() { return mTurnProfiler; }
+	const TurnProfiler& turnProfiler() const { return mTurnProfiler; }
+
+	const std::vector<Tile*>& connectednessOverlay() const;
+	const std::vector<Tile*>& commRangeOverlay() const { return mCommRangeCoverage.tiles(0); }
+	const std::vector<std::vector<Tile*>>& policeOverlays() const { return mPoliceCoverage.tiles(); }
+
+	const CoverageGrid& commRangeCoverage() const { return mCommRangeCoverage; }
+	const CoverageGrid& policeCoverage() const { return mPoliceCoverage; }
+	const std::vector<LogisticsTable::RouteId>& truckRouteOverlay() const { return mTruckRouteOverlay; }
+
+	Robot& addRobot(Robot::Type type);
+	void deployRobot(Robot& robot, Tile& tile);
+	void insertTube(ConnectorDir dir, int depth, Tile& tile);
+	void dozeTile(Tile& tile);
+
+	void updateConnectedness();
+	void updateCommRangeOverlay();
+	void updatePoliceOverlay();
+	void updatePlayerResources();
+
+	void scrubRobotList();
+
+	// STRUCTURE EVENT HANDLERS
+	void onDeployCargoLander();
+	void onDeployColonistLander();
+	void onDeploySeedLander(NAS2D::Point<int> point);
+	void onFactoryProductionComplete(Factory& factory);
+	void onMineFacilityExtend(MineFacility* mf);
+
+private:
+	ColonySimulation(const ColonySimulation&) = delete;
+	ColonySimulation& operator=(const ColonySimulation&) = delete;
+
+	// ROBOT EVENT HANDLERS
+	void onDiggerTaskComplete(Robot* robot);
+	void onMinerTaskComplete(Robot* robot);
+
+	void pullRobotFromFactory(ProductType pt, Factory& factory);
+
+	void resetCoverage();
+	void tileRouteCostChanged(Tile& tile);
+	void takeRobotOffTile(Robot& robot, Tile& tile);
+	void onStructureRemoved(Tile& tile);
+	void addMoraleReason(const std::string& reason, int value);
+
+	// TURN LOGIC
+	void checkColonyShip();
+	void updatePopulation();
+	void updateCommercial();
+	void updateMaintenance();
+	void updateMorale();
+	void updateResidentialCapacity();
+	void updateBiowasteRecycling();
+	void updateFood();
+	void transferFoodToCommandCenter();
+	void updateResources();
+	void updateRoads();
+	void updateRobots();
+
+	void findMineRoutes();
+	void transportOreFromMines();
+	void transportResourcesToStorage();
+
+	void checkAgingStructures();
+	void checkNewlyBuiltStructures();
+
+	// SAVE GAME MANAGEMENT FUNCTIONS
+	std::map<int, Robot*> readRobots(NAS2D::Xml::XmlElement* element);
+	void readStructures(NAS2D::Xml::XmlElement* element, const std::map<int, Robot*>& idToRobotMap);
+	void readTurns(NAS2D::Xml::XmlElement* element);
+	void readPopulation(NAS2D::Xml::XmlElement* element);
+	void readMoraleChanges(NAS2D::Xml::XmlElement* element);
+	void readRandomState(NAS2D::Xml::XmlElement* element);
+
+private:
+	Planet::Attributes mPlanetAttributes;
+	Difficulty mDifficulty = Difficulty::Medium;
+
+	TileMap* mTileMap{nullptr};
+	std::unique_ptr<ConnectivityIndex> mConnectivityIndex;
+	std::unique_ptr<OreLogisticsPlanner> mOreLogistics;
+
+	NotificationSignal mNotificationSignal;
+	RobotRemovedSignal mRobotRemovedSignal;
+
+	CrimeRateUpdate mCrimeRateUpdate;
+	CrimeExecution mCrimeExecution;
+
+	ResearchTracker mResearchTracker;
+
+	// POOLS
+	StorableResources mResourcesCount;
+	RobotPool mRobotPool; /**< Robots that are currently available for use. */
+	PopulationPool mPopulationPool;
+
+	RobotTileTable mRobotList; /**< List of active robots and their positions on the map. */
+
+	Population mPopulation;
+
+	int mFood{0};
+	int mTurnCount{0};
+
+	int mCurrentMorale{constants::DefaultStartingMorale};
+	int mPreviousMorale{constants::DefaultStartingMorale};
+
+	int mLandersColonist{0};
+	int mLandersCargo{0};
+
+	int mResidentialCapacity{0};
+
+	MoraleChangeList mMoraleChanges;
+
+	TurnProfiler mTurnProfiler;
+
+	CoverageGrid mCommRangeCoverage;
+	CoverageGrid mPoliceCoverage;
+	std::vector<LogisticsTable::RouteId> mTruckRouteOverlay; /**< Every mine's route as of the last turn, kept or new. */
+};
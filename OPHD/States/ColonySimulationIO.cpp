@@ -0,0 +1,525 @@
+// ==================================================================================
+// = This file implements restoring a ColonySimulation from a savegame. Writing the
+// = savegame is still handled by MapViewState as it also stores view state.
+// ==================================================================================
+
+#include "ColonySimulation.h"
+
+#include "MapViewStateHelper.h"
+#include "LogisticsTable.h"
+
+#include "../IOHelper.h"
+#include "../StructureCatalogue.h"
+#include "../StructureManager.h"
+#include "../XmlSerializer.h"
+#include "../Map/TileMap.h"
+#include "../Things/Robots/Robots.h"
+
+#include <NAS2D/Utility.h>
+#include <NAS2D/Dictionary.h>
+#include <NAS2D/ParserHelper.h>
+#include <NAS2D/StringUtils.h>
+#include <NAS2D/Xml/XmlElement.h>
+
+#include <map>
+#include <string>
+#include <stdexcept>
+
+
+namespace
+{
+	const std::map<RandomStream, std::string> RandomStreamNames
+	{
+		{RandomStream::General, "general"},
+		{RandomStream::PopulationRetirement, "population_retirement"},
+		{RandomStream::CrimeRate, "crime_rate"},
+		{RandomStream::CrimeExecution, "crime_execution"},
+		{RandomStream::MinePlacement, "mine_placement"},
+	};
+
+
+	MapCoordinate loadMapCoordinate(const NAS2D::Dictionary& dictionary)
+	{
+		const auto x = dictionary.get<int>("x");
+		const auto y = dictionary.get<int>("y");
+		const auto depth = dictionary.get<int>("depth");
+		return MapCoordinate{{x, y}, depth};
+	}
+
+
+	void loadResorucesFromXmlElement(NAS2D::Xml::XmlElement* element, StorableResources& resources)
+	{
+		if (!element) { return; }
+
+		resources = readResources(element);
+	}
+
+
+	void readRccRobots(std::string robotIds, const std::map<int, Robot*>& idToRobotMap, RobotCommand& robotCommand)
+	{
+		for (const auto& string : NAS2D::split(robotIds, ','))
+		{
+			const auto robotId = NAS2D::stringTo<int>(string);
+			robotCommand.addRobot(idToRobotMap.at(robotId));
+		}
+	}
+
+
+	ResearchTracker readResearch(NAS2D::Xml::XmlElement* element)
+	{
+		ResearchTracker tracker;
+
+		if (!element) { return tracker; }
+
+		const auto researchList = NAS2D::split(element->attribute("completed_techs"));
+
+		for (auto& item : researchList)
+		{
+			tracker.addCompletedResearch(std::stoi(item));
+		}
+
+		for (auto currentResearch = element->firstChildElement();
+			currentResearch != nullptr;
+			currentResearch = currentResearch->nextSiblingElement())
+		{
+			const auto dictionary = NAS2D::attributesToDictionary(*currentResearch);
+
+			tracker.startResearch(
+				dictionary.get<int>("tech_id"),
+				dictionary.get<int>("progress"),
+				dictionary.get<int>("assigned")
+			);
+		}
+
+		return tracker;
+	}
+}
+
+
+NAS2D::Xml::XmlElement* ColonySimulation::serializeProperties() const
+{
+	return NAS2D::dictionaryToAttributes(
+		"properties",
+		{{
+			{"sitemap", mPlanetAttributes.mapImagePath},
+			{"tset", mPlanetAttributes.tilesetPath},
+			{"diggingdepth", mPlanetAttributes.maxDepth},
+			{"mapwidth", mTileMap->size().x},
+			{"mapheight", mTileMap->size().y},
+			{"meansolardistance", mPlanetAttributes.meanSolarDistance},
+			{"difficulty", difficultyString(mDifficulty)},
+		}}
+	);
+}
+
+
+/**
+ * Writes the random seed along with how far each stream has advanced so
+ * a loaded game continues with exactly the same random sequence.
+ */
+NAS2D::Xml::XmlElement* ColonySimulation::serializeRandomState() const
+{
+	auto* random = new NAS2D::Xml::XmlElement("random");
+	random->attribute("seed", std::to_string(randomStreams.seed()));
+
+	for (const auto& [stream, name] : RandomStreamNames)
+	{
+		random->attribute(name, std::to_string(randomStreams[stream].counter()));
+	}
+
+	return random;
+}
+
+
+/**
+ * Replaces the current colony with the one stored under a savegame's
+ * root element.
+ */
+void ColonySimulation::load(NAS2D::Xml::XmlElement* root)
+{
+	scrubRobotList();
+	NAS2D::Utility<StructureManager>::get().dropAllStructures();
+	ccLocation() = CcNotPlaced;
+	mTurnProfiler.clear();
+
+	mConnectivityIndex.reset();
+	mOreLogistics.reset();
+	delete mTileMap;
+	mTileMap = nullptr;
+
+	NAS2D::Xml::XmlElement* map = root->firstChildElement("properties");
+	const auto dictionary = NAS2D::attributesToDictionary(*map);
+
+	mPlanetAttributes = Planet::Attributes();
+	mPlanetAttributes.maxDepth = dictionary.get<int>("diggingdepth");
+	mPlanetAttributes.mapImagePath = dictionary.get("sitemap");
+	mPlanetAttributes.tilesetPath = dictionary.get("tset");
+	mPlanetAttributes.meanSolarDistance = dictionary.get<float>("meansolardistance");
+
+	difficulty(stringToEnum(difficultyTable, dictionary.get("difficulty", std::string{"Medium"})));
+
+	readRandomState(root->firstChildElement("random"));
+
+	StructureCatalogue::init(mPlanetAttributes.meanSolarDistance);
+	mTileMap = new TileMap(mPlanetAttributes.mapImagePath, mPlanetAttributes.maxDepth);
+
+	// Older saves don't record the map size, the heightmap is all there is to go on
+	const auto savedMapSize = NAS2D::Vector{dictionary.get<int>("mapwidth", 0), dictionary.get<int>("mapheight", 0)};
+	if (savedMapSize != NAS2D::Vector{0, 0} && savedMapSize != mTileMap->size())
+	{
+		const auto mapSize = mTileMap->size();
+		throw std::runtime_error(
+			"ColonySimulation::load(): Saved map size " + std::to_string(savedMapSize.x) + "x" + std::to_string(savedMapSize.y) +
+			" doesn't match heightmap size " + std::to_string(mapSize.x) + "x" + std::to_string(mapSize.y)
+		);
+	}
+
+	mTileMap->deserialize(root);
+	mConnectivityIndex = std::make_unique<ConnectivityIndex>(*mTileMap);
+	mOreLogistics = std::make_unique<OreLogisticsPlanner>(*mTileMap);
+	resetCoverage();
+
+	NAS2D::Utility<LogisticsTable>::get().clear();
+
+	/**
+	 * In the case of loading a game, the Robot Command Center depends on the robot list
+	 * having already been loaded in order to match up the robots in the save game to
+	 * the RCC.
+	 */
+	const auto idToRobotMap = readRobots(root->firstChildElement("robots"));
+	readStructures(root->firstChildElement("structures"), idToRobotMap);
+
+	mResearchTracker = readResearch(root->firstChildElement("research"));
+
+	readPopulation(root->firstChildElement("population"));
+	readTurns(root->firstChildElement("turns"));
+
+	readMoraleChanges(root->firstChildElement("morale_change"));
+
+	updateConnectedness();
+
+	NAS2D::Utility<StructureManager>::get().updateEnergyProduction();
+	NAS2D::Utility<StructureManager>::get().updateEnergyConsumed();
+	NAS2D::Utility<StructureManager>::get().assignColonistsToResidences(mPopulationPool);
+
+	updateRobotControl(mRobotPool);
+	updateResidentialCapacity();
+
+	updateRoads();
+	findMineRoutes();
+	updateFood();
+	NAS2D::Utility<StructureManager>::get().refinedResources().recount();
+	updatePlayerResources();
+
+	if (mTurnCount == 0 && NAS2D::Utility<StructureManager>::get().count() != 0)
+	{
+		/**
+		 * There should only ever be one structure if the turn count is 0, the
+		 * SEED Lander which at this point should not have been deployed.
+		 */
+		const auto& list = NAS2D::Utility<StructureManager>::get().getStructures<SeedLander>();
+		if (list.size() != 1) { throw std::runtime_error("ColonySimulation::load(): Turn counter at 0 but more than one structure in list."); }
+
+		SeedLander* seedLander = list[0];
+		if (!seedLander) { throw std::runtime_error("ColonySimulation::load(): Structure in list is not a SeedLander."); }
+
+		seedLander->deploySignal().connect(this, &ColonySimulation::onDeploySeedLander);
+	}
+
+	updateCommRangeOverlay();
+	updatePoliceOverlay();
+}
+
+
+std::map<int, Robot*> ColonySimulation::readRobots(NAS2D::Xml::XmlElement* element)
+{
+	mRobotPool.clear();
+	mRobotList.clear();
+
+	std::map<int, Robot*> idToRobotMap{};
+
+	for (NAS2D::Xml::XmlElement* robotElement = element->firstChildElement(); robotElement; robotElement = robotElement->nextSiblingElement())
+	{
+		const auto dictionary = NAS2D::attributesToDictionary(*robotElement);
+
+		const auto id = dictionary.get<int>("id");
+		const auto type = dictionary.get<int>("type");
+		const auto age = dictionary.get<int>("age");
+		const auto production_time = dictionary.get<int>("production");
+		const auto x = dictionary.get<int>("x", 0);
+		const auto y = dictionary.get<int>("y", 0);
+		const auto depth = dictionary.get<int>("depth", 0);
+		const auto direction = dictionary.get<int>("direction", 0);
+
+		const auto robotType = static_cast<Robot::Type>(type);
+		auto& robot = addRobot(robotType);
+		if (robotType == Robot::Type::Digger)
+		{
+			static_cast<Robodigger&>(robot).direction(static_cast<Direction>(direction));
+		}
+
+		idToRobotMap[id] = &robot;
+
+		robot.fuelCellAge(age);
+
+		if (production_time > 0)
+		{
+			robot.startTask(production_time);
+			mRobotPool.insertRobotIntoTable(mRobotList, robot, mTileMap->getTile({{x, y}, depth}));
+			mRobotList[&robot]->index(TerrainType::Dozed);
+		}
+
+		if (depth > 0)
+		{
+			mRobotList[&robot]->excavated(true);
+		}
+	}
+
+	return idToRobotMap;
+}
+
+
+void ColonySimulation::readStructures(NAS2D::Xml::XmlElement* element, const std::map<int, Robot*>& idToRobotMap)
+{
+	for (NAS2D::Xml::XmlElement* structureElement = element->firstChildElement(); structureElement != nullptr; structureElement = structureElement->nextSiblingElement())
+	{
+		const auto dictionary = NAS2D::attributesToDictionary(*structureElement);
+
+		const auto type = dictionary.get<int>("type");
+		const auto age = dictionary.get<int>("age");
+		const auto state = dictionary.get<int>("state");
+		const auto direction = dictionary.get<int>("direction");
+		const auto forced_idle = dictionary.get<bool>("forced_idle");
+		const auto disabled_reason = dictionary.get<int>("disabled_reason");
+		const auto idle_reason = dictionary.get<int>("idle_reason");
+
+		const auto crime_rate = dictionary.get<int>("crime_rate", 0);
+		const auto integrity = dictionary.get<int>("integrity", 100);
+
+		const auto production_completed = dictionary.get<int>("production_completed", 0);
+		const auto production_type = dictionary.get<int>("production_type", 0);
+
+		const auto pop0 = dictionary.get<int>("pop0");
+		const auto pop1 = dictionary.get<int>("pop1");
+
+		const auto mapCoordinate = loadMapCoordinate(dictionary);
+		auto& tile = mTileMap->getTile(mapCoordinate);
+		tile.index(TerrainType::Dozed);
+		tile.excavated(true);
+
+		auto structureId = static_cast<StructureID>(type);
+		if (structureId == StructureID::SID_TUBE)
+		{
+			ConnectorDir connectorDir = static_cast<ConnectorDir>(direction);
+			insertTube(connectorDir, mapCoordinate.z, mTileMap->getTile(mapCoordinate));
+			continue; // FIXME: ugly
+		}
+
+		auto& structure = *StructureCatalogue::get(structureId);
+
+		if (structureId == StructureID::SID_COMMAND_CENTER)
+		{
+			ccLocation() = mapCoordinate.xy;
+		}
+
+		if (structureId == StructureID::SID_MINE_FACILITY)
+		{
+			auto* mine = mTileMap->getTile({mapCoordinate.xy, 0}).mine();
+			if (mine == nullptr)
+			{
+				throw std::runtime_error("Mine Facility is located on a Tile with no Mine.");
+			}
+
+			auto& mineFacility = *static_cast<MineFacility*>(&structure);
+			mineFacility.mine(mine);
+			mineFacility.maxDepth(mTileMap->maxDepth());
+			mineFacility.extensionComplete().connect(this, &ColonySimulation::onMineFacilityExtend);
+
+			auto trucks = structureElement->firstChildElement("trucks");
+			if (trucks)
+			{
+				mineFacility.assignedTrucks(NAS2D::attributesToDictionary(*trucks).get<int>("assigned"));
+			}
+
+			auto extension = structureElement->firstChildElement("extension");
+			if (extension)
+			{
+				mineFacility.digTimeRemaining(NAS2D::attributesToDictionary(*extension).get<int>("turns_remaining"));
+			}
+		}
+
+		if (structureId == StructureID::SID_AIR_SHAFT && mapCoordinate.z != 0)
+		{
+			static_cast<AirShaft*>(&structure)->ug(); // force underground state
+		}
+
+		if (structureId == StructureID::SID_SEED_LANDER)
+		{
+			static_cast<SeedLander*>(&structure)->position(mapCoordinate.xy);
+		}
+
+		if (structureId == StructureID::SID_AGRIDOME ||
+			structureId == StructureID::SID_COMMAND_CENTER)
+		{
+			auto& foodProduction = *static_cast<FoodProduction*>(&structure);
+
+			auto foodStorage = structureElement->firstChildElement("food");
+			if (foodStorage == nullptr)
+			{
+				throw std::runtime_error("ColonySimulation::readStructures(): FoodProduction structure saved without a food level node.");
+			}
+
+			foodProduction.foodLevel(NAS2D::attributesToDictionary(*foodStorage).get<int>("level"));
+		}
+
+		structure.age(age);
+		structure.forced_state_change(static_cast<StructureState>(state), static_cast<DisabledReason>(disabled_reason), static_cast<IdleReason>(idle_reason));
+		structure.connectorDirection(static_cast<ConnectorDir>(direction));
+		structure.integrity(integrity);
+
+		if (forced_idle != 0) { structure.forceIdle(forced_idle != 0); }
+
+		loadResorucesFromXmlElement(structureElement->firstChildElement("production"), structure.production());
+		loadResorucesFromXmlElement(structureElement->firstChildElement("storage"), structure.storage());
+
+		if (structure.structureClass() == Structure::StructureClass::Residence)
+		{
+			auto waste = structureElement->firstChildElement("waste");
+			if (waste)
+			{
+				auto& residence = *static_cast<Residence*>(&structure);
+				const auto wasteDictionary = NAS2D::attributesToDictionary(*waste);
+				residence.wasteAccumulated(wasteDictionary.get<int>("accumulated"));
+				residence.wasteOverflow(wasteDictionary.get<int>("overflow"));
+			}
+		}
+
+		if (structure.structureClass() == Structure::StructureClass::Maintenance)
+		{
+			auto personnel = structureElement->firstChildElement("personnel");
+			if (personnel)
+			{
+				auto& maintenanceFacility = *static_cast<MaintenanceFacility*>(&structure);
+				maintenanceFacility.personnel(NAS2D::attributesToDictionary(*personnel).get<int>("assigned", 0));
+				maintenanceFacility.resources(mResourcesCount);
+			}
+		}
+
+		if (structure.isWarehouse())
+		{
+			auto& warehouse = *static_cast<Warehouse*>(&structure);
+			warehouse.products().deserialize(NAS2D::attributesToDictionary(
+				*structureElement->firstChildElement("warehouse_products")
+			));
+		}
+
+		if (structure.isFactory())
+		{
+			auto& factory = *static_cast<Factory*>(&structure);
+			factory.productType(static_cast<ProductType>(production_type));
+			factory.productionTurnsCompleted(production_completed);
+			factory.resourcePool(&mResourcesCount);
+			factory.productionComplete().connect(this, &ColonySimulation::onFactoryProductionComplete);
+		}
+
+		if (structure.isRobotCommand())
+		{
+			auto robotsElement = structureElement->firstChildElement("robots");
+			if (robotsElement)
+			{
+				const auto robotIds = NAS2D::attributesToDictionary(*robotsElement).get("robots");
+				auto& robotCommand = *static_cast<RobotCommand*>(&structure);
+				readRccRobots(robotIds, idToRobotMap, robotCommand);
+			}
+		}
+
+		if (structure.hasCrime())
+		{
+			structure.crimeRate(crime_rate);
+		}
+
+		structure.populationAvailable() = {pop0, pop1};
+
+		NAS2D::Utility<StructureManager>::get().addStructure(structure, tile);
+	}
+}
+
+
+void ColonySimulation::readTurns(NAS2D::Xml::XmlElement* element)
+{
+	if (element)
+	{
+		mTurnCount = NAS2D::attributesToDictionary(*element).get<int>("count");
+	}
+}
+
+
+/**
+ * Reads the population tag.
+ */
+void ColonySimulation::readPopulation(NAS2D::Xml::XmlElement* element)
+{
+	if (element)
+	{
+		mPopulation = {};
+
+		const auto dictionary = NAS2D::attributesToDictionary(*element);
+
+		mLandersColonist = dictionary.get<int>("colonist_landers");
+		mLandersCargo = dictionary.get<int>("cargo_landers");
+
+		mCurrentMorale = dictionary.get<int>("morale");
+		mPreviousMorale = dictionary.get<int>("prev_morale");
+
+		const auto children = dictionary.get<int>("children");
+		const auto students = dictionary.get<int>("students");
+		const auto workers = dictionary.get<int>("workers");
+		const auto scientists = dictionary.get<int>("scientists");
+		const auto retired = dictionary.get<int>("retired");
+
+		mPopulation.addPopulation({children, students, workers, scientists, retired});
+	}
+}
+
+
+void ColonySimulation::readMoraleChanges(NAS2D::Xml::XmlElement* moraleChangeElement)
+{
+	mMoraleChanges.clear();
+
+	if (!moraleChangeElement) { return; }
+
+	for (auto messageElement = moraleChangeElement->firstChildElement(); messageElement; messageElement = messageElement->nextSiblingElement())
+	{
+		const auto dictionary = NAS2D::attributesToDictionary(*messageElement);
+
+		const auto message = dictionary.get("message");
+		const auto val = dictionary.get<int>("val");
+
+		addMoraleReason(message, val);
+	}
+}
+
+
+/**
+ * Restores the random seed and stream positions. Savegames written before
+ * the seed was stored get a fresh seed.
+ */
+void ColonySimulation::readRandomState(NAS2D::Xml::XmlElement* element)
+{
+	if (!element)
+	{
+		randomStreams.seed(RandomStreams::newSeed());
+		return;
+	}
+
+	randomStreams.seed(std::stoull(element->attribute("seed")));
+
+	for (const auto& [stream, name] : RandomStreamNames)
+	{
+		const auto counter = element->attribute(name);
+		if (!counter.empty())
+		{
+			randomStreams[stream].counter(std::stoull(counter));
+		}
+	}
+}
@@ -0,0 +1,730 @@
+// ==================================================================================
+// = This file implements the functions that handle processing a turn.
+// ==================================================================================
+
+#include "ColonySimulation.h"
+#include "MapViewStateHelper.h"
+
+#include "LogisticsTable.h"
+
+#include "../Map/TileMap.h"
+
+#include "../Common.h"
+#include "../DirectionOffset.h"
+#include "../StorableResources.h"
+#include "../StructureManager.h"
+
+#include <NAS2D/Utility.h>
+
+#include <vector>
+#include <span>
+#include <algorithm>
+
+
+namespace
+{
+	constexpr int SmelterOreCapacity = 250; /**< Ore a smelter holds waiting to be refined. */
+
+
+	int consumeFood(FoodProduction& producer, int amountToConsume)
+	{
+		const auto foodLevel = producer.foodLevel();
+		const auto toTransfer = std::min(foodLevel, amountToConsume);
+
+		producer.foodLevel(foodLevel - toTransfer);
+		return toTransfer;
+	}
+
+
+	/**
+	 * Consumes food from each producer in order and returns the amount
+	 * that could not be consumed.
+	 */
+	template <typename FoodProducerType>
+	int consumeFood(std::span<FoodProducerType* const> foodProducers, int amountToConsume)
+	{
+		for (auto foodProducer : foodProducers)
+		{
+			if (amountToConsume <= 0) { break; }
+			amountToConsume -= consumeFood(*foodProducer, amountToConsume);
+		}
+		return amountToConsume;
+	}
+
+
+	void pushAgingRobotMessage(const Robot* robot, const MapCoordinate& position, ColonySimulation::NotificationSignal& notificationSignal)
+	{
+		const auto robotLocationText = "(" + std::to_string(position.xy.x) + ", " + std::to_string(position.xy.y) + ")";
+
+		if (robot->fuelCellAge() == 190) /// \fixme magic number
+		{
+			notificationSignal({
+				"Aging Robot",
+				"Robot '" + robot->name() + "' at location " + robotLocationText + " is approaching its maximum age.",
+				position,
+				NotificationType::Warning});
+		}
+		else if (robot->fuelCellAge() == 195) /// \fixme magic number
+		{
+			notificationSignal({
+				"Aging Robot",
+				"Robot '" + robot->name() + "' at location " + robotLocationText + " will fail in a few turns. Replace immediately.",
+				position,
+				NotificationType::Critical});
+		}
+	}
+}
+
+
+void ColonySimulation::updatePopulation()
+{
+	StructureManager& structureManager = NAS2D::Utility<StructureManager>::get();
+
+	int residences = structureManager.getCountInState(Structure::StructureClass::Residence, StructureState::Operational);
+	int universities = structureManager.getCountInState(Structure::StructureClass::University, StructureState::Operational);
+	int nurseries = structureManager.getCountInState(Structure::StructureClass::Nursery, StructureState::Operational);
+	int hospitals = structureManager.getCountInState(Structure::StructureClass::MedicalCenter, StructureState::Operational);
+
+	int amountToConsume = mPopulation.update(mCurrentMorale, mFood, residences, universities, nurseries, hospitals);
+	amountToConsume = consumeFood(structureManager.getStructures<FoodProduction>(), amountToConsume);
+	consumeFood(structureManager.getStructures<CommandCenter>(), amountToConsume);
+}
+
+
+void ColonySimulation::updateCommercial()
+{
+	StructureManager& structureManager = NAS2D::Utility<StructureManager>::get();
+
+	const auto& warehouses = structureManager.getStructures<Warehouse>();
+	const auto& commercial = structureManager.getStructures<Commercial>();
+
+	// No need to do anything if there are no commercial structures.
+	if (commercial.empty()) { return; }
+
+	int luxuryCount = structureManager.getCountInState(Structure::StructureClass::Commercial, StructureState::Operational);
+	int commercialCount = luxuryCount;
+
+	for (auto warehouse : warehouses)
+	{
+		ProductPool& productPool = warehouse->products();
+
+		/**
+		 * inspect for luxury products.
+		 * 
+		 * \fixme	I feel like this could be done better. At the moment there
+		 *			is only one luxury item, clothing, but as this changes more
+		 *			items may be seen as luxury.
+		 */
+		int clothing = productPool.count(ProductType::PRODUCT_CLOTHING);
+
+		if (clothing >= luxuryCount)
+		{
+			productPool.pull(ProductType::PRODUCT_CLOTHING, luxuryCount);
+			luxuryCount = 0;
+			break;
+		}
+		else if (clothing < luxuryCount)
+		{
+			productPool.pull(ProductType::PRODUCT_CLOTHING, clothing);
+			luxuryCount -= clothing;
+		}
+
+		if (luxuryCount == 0)
+		{
+			break;
+		}
+	}
+
+	auto commercialReverseIterator = commercial.rbegin();
+	for (std::size_t i = 0; i < static_cast<std::size_t>(luxuryCount) && commercialReverseIterator != commercial.rend(); ++i, ++commercialReverseIterator)
+	{
+		if ((*commercialReverseIterator)->operational())
+		{
+			(*commercialReverseIterator)->idle(IdleReason::InsufficientLuxuryProduct);
+		}
+	}
+
+	mCurrentMorale += commercialCount - luxuryCount;
+}
+
+
+void ColonySimulation::updateMorale()
+{
+	StructureManager& structureManager = NAS2D::Utility<StructureManager>::get();
+
+	// POSITIVE MORALE EFFECTS
+	// =========================================
+	const int birthCount = mPopulation.birthCount();
+	const int parkCount = structureManager.getCountInState(Structure::StructureClass::Park, StructureState::Operational);
+	const int recreationCount = structureManager.getCountInState(Structure::StructureClass::RecreationCenter, StructureState::Operational);
+	const int foodProducingStructures = structureManager.getCountInState(Structure::StructureClass::FoodProduction, StructureState::Operational);
+	const int commercialCount = structureManager.getCountInState(Structure::StructureClass::Commercial, StructureState::Operational);
+
+	// NEGATIVE MORALE EFFECTS
+	// =========================================
+	const int deathCount = mPopulation.deathCount();
+	const int structuresDisabled = structureManager.disabled();
+	const int structuresDestroyed = structureManager.destroyed();
+	const int residentialOverCapacityHit = mPopulation.getPopulations().size() > mResidentialCapacity ? 2 : 0;
+	const int foodProductionHit = foodProducingStructures > 0 ? 0 : 5;
+
+	auto& residences = NAS2D::Utility<StructureManager>::get().getStructures<Residence>();
+	int bioWasteAccumulation = 0;
+	for (auto residence : residences)
+	{
+		if (residence->wasteOverflow() > 0) { ++bioWasteAccumulation; }
+	}
+
+	// positive
+	mCurrentMorale += birthCount;
+	mCurrentMorale += parkCount;
+	mCurrentMorale += recreationCount;
+	mCurrentMorale += commercialCount;
+
+	// negative
+	mCurrentMorale -= deathCount;
+	mCurrentMorale -= residentialOverCapacityHit;
+	mCurrentMorale -= bioWasteAccumulation * 2;
+	mCurrentMorale -= structuresDisabled;
+	mCurrentMorale -= structuresDestroyed;
+	mCurrentMorale -= foodProductionHit;
+
+	mCurrentMorale = std::clamp(mCurrentMorale, 0, 1000);
+
+	mMoraleChanges.clear();
+	addMoraleReason(moraleString(Morale::Births), birthCount);
+	addMoraleReason(moraleString(Morale::Deaths), -deathCount);
+	addMoraleReason(moraleString(Morale::NoFoodProduction), -foodProductionHit);
+	addMoraleReason(moraleString(Morale::Parks), parkCount);
+	addMoraleReason(moraleString(Morale::Recreation), recreationCount);
+	addMoraleReason(moraleString(Morale::Commercial), commercialCount);
+	addMoraleReason(moraleString(Morale::ResidentialOverflow), -residentialOverCapacityHit);
+	addMoraleReason(moraleString(Morale::BiowasteOverflow), bioWasteAccumulation * -2);
+	addMoraleReason(moraleString(Morale::StructuresDisabled), -structuresDisabled);
+	addMoraleReason(moraleString(Morale::StructuresDestroyed), -structuresDestroyed);
+
+	for (const auto& moraleReason : mCrimeRateUpdate.moraleChanges())
+	{
+		addMoraleReason(moraleReason.first, moraleReason.second);
+		mCurrentMorale += moraleReason.second;
+	}
+
+	for (const auto& moraleReason : mCrimeExecution.moraleChanges())
+	{
+		addMoraleReason(moraleReason.first, moraleReason.second);
+		mCurrentMorale += moraleReason.second;
+	}
+
+	// Push notifications
+	if (birthCount)
+	{
+		mNotificationSignal({
+			"Baby Born",
+			std::to_string(birthCount) + (birthCount > 1 ? " babies were born." : " baby was born."),
+			{{-1, -1}, 0},
+			NotificationType::Information});
+	}
+
+	if (deathCount)
+	{
+		mNotificationSignal({
+			"Colonist Died",
+			std::to_string(deathCount) + (birthCount > 1 ? " colonists met their demise." : " colonist met their demise."),
+			{{-1, -1}, 0},
+			NotificationType::Warning});
+	}
+}
+
+
+void ColonySimulation::findMineRoutes()
+{
+	auto& structureManager = NAS2D::Utility<StructureManager>::get();
+	auto& logisticsTable = NAS2D::Utility<LogisticsTable>::get();
+	mTruckRouteOverlay.clear();
+
+	mOreLogistics->update(structureManager.getStructures<OreRefining>());
+
+	// Routes are dropped from the table when a tile along them changes
+	for (auto mine : structureManager.getStructures<MineFacility>())
+	{
+		mine->mine()->checkExhausted();
+
+		if (!mine->operational() && !mine->isIdle()) { continue; } // consider a different control path.
+
+		const auto routeId = logisticsTable.routeIdFor(*mine);
+		if (routeId != LogisticsTable::NoRoute)
+		{
+			if (logisticsTable.smelter(routeId).operational())
+			{
+				mTruckRouteOverlay.push_back(routeId);
+				continue;
+			}
+			logisticsTable.remove(routeId);
+		}
+
+		const auto destinations = mOreLogistics->destinations(*mine);
+		if (destinations.empty()) { continue; } // give up and move on to the next mine
+
+		auto& smelter = *destinations.front().smelter;
+		mTruckRouteOverlay.push_back(logisticsTable.add(*mine, smelter, mOreLogistics->route(*mine, smelter)));
+	}
+}
+
+
+/**
+ * Trucks haul ore to the cheapest smelter with room for it. Once that
+ * smelter is full the trucks' remaining time goes to the next cheapest,
+ * and so on.
+ */
+void ColonySimulation::transportOreFromMines()
+{
+	for (auto mine : NAS2D::Utility<StructureManager>::get().getStructures<MineFacility>())
+	{
+		if (!mine->operational() && !mine->isIdle()) { continue; }
+		if (mine->assignedTrucks() == 0) { continue; }
+
+		auto& mineStored = mine->storage();
+
+		// Share of the trucks' time not yet spent this turn
+		float truckTimeLeft = 1.0f;
+		for (const auto& [smelter, cost] : mOreLogistics->destinations(*mine))
+		{
+			if (truckTimeLeft <= 0.0f || mineStored.isEmpty()) { break; }
+
+			/* clamp route cost to minimum of 1.0f for next computation to avoid
+			   unintended multiplication. */
+			const float routeCost = std::clamp(cost, 1.0f, FLT_MAX);
+
+			/* intentional truncation of fractional component*/
+			const int fullOreMovement = static_cast<int>(constants::ShortestPathTraversalCount / routeCost) * mine->assignedTrucks();
+			const int totalOreMovement = static_cast<int>(static_cast<float>(fullOreMovement) * truckTimeLeft);
+			if (totalOreMovement <= 0) { break; }
+
+			const int oreMovementPart = totalOreMovement / 4;
+			const int oreMovementRemainder = totalOreMovement % 4;
+			const auto movementCap = StorableResources{oreMovementPart, oreMovementPart, oreMovementPart, oreMovementPart + oreMovementRemainder};
+
+			auto& smelterStored = smelter->production();
+
+			const auto oreAvailable = smelterStored + mineStored.cap(movementCap);
+			const auto newSmelterStored = oreAvailable.cap(SmelterOreCapacity);
+			const auto movedOre = newSmelterStored - smelterStored;
+
+			mineStored -= movedOre;
+			smelterStored = newSmelterStored;
+
+			truckTimeLeft -= static_cast<float>(movedOre.total()) / static_cast<float>(fullOreMovement);
+		}
+	}
+}
+
+
+void ColonySimulation::transportResourcesToStorage()
+{
+	auto& smelterList = NAS2D::Utility<StructureManager>::get().getStructures<OreRefining>();
+	for (auto smelter : smelterList)
+	{
+		if (!smelter->operational() && !smelter->isIdle()) { continue; }
+
+		auto& stored = smelter->storage();
+		const auto toMove = stored.cap(25);
+
+		const auto unmoved = addRefinedResources(toMove);
+		stored -= (toMove - unmoved);
+	}
+}
+
+
+void ColonySimulation::updateResources()
+{
+	findMineRoutes();
+	transportOreFromMines();
+	transportResourcesToStorage();
+	updatePlayerResources();
+}
+
+
+/**
+ * Check for colony ship deorbiting; if any colonists are remaining, kill
+ * them and reduce morale by an appropriate amount.
+ */
+void ColonySimulation::checkColonyShip()
+{
+	if (mTurnCount == constants::ColonyShipOrbitTime)
+	{
+		if (mLandersColonist > 0 || mLandersCargo > 0)
+		{
+			mCurrentMorale -= (mLandersColonist * 50) * 6; /// \todo apply a modifier to multiplier based on difficulty level.
+			if (mCurrentMorale < 0) { mCurrentMorale = 0; }
+
+			mLandersColonist = 0;
+			mLandersCargo = 0;
+		}
+	}
+}
+
+
+void ColonySimulation::updateResidentialCapacity()
+{
+	mResidentialCapacity = 0;
+	const auto& residences = NAS2D::Utility<StructureManager>::get().getStructures<Residence>();
+	for (auto residence : residences)
+	{
+		if (residence->operational()) { mResidentialCapacity += residence->capacity(); }
+	}
+
+	if (residences.empty()) { mResidentialCapacity = constants::CommandCenterPopulationCapacity; }
+
+}
+
+
+void ColonySimulation::updateBiowasteRecycling()
+{
+	auto& residences = NAS2D::Utility<StructureManager>::get().getStructures<Residence>();
+	auto& recyclingFacilities = NAS2D::Utility<StructureManager>::get().getStructures<Recycling>();
+
+	if (residences.empty() || recyclingFacilities.empty()) { return; }
+
+	auto residenceIterator = residences.begin();
+	for (auto recycling : recyclingFacilities)
+	{
+		if (!recycling->operational()) { continue; } // Consider a different control structure
+
+		for (int count = 0; count < recycling->residentialSupportCount(); ++count)
+		{
+			if (residenceIterator == residences.end())
+			{
+				return; // No more residences, so don't waste time iterating over remaining recycling facilities
+			}
+
+			Residence* residence = static_cast<Residence*>(*residenceIterator);
+			residence->pullWaste(recycling->wasteProcessingCapacity());
+			++residenceIterator;
+		}
+	}
+}
+
+
+void ColonySimulation::updateFood()
+{
+	mFood = 0;
+
+	const auto addFoodLevels = [this](auto foodProducers)
+	{
+		for (auto foodProdcer : foodProducers)
+		{
+			if (foodProdcer->operational() || foodProdcer->isIdle())
+			{
+				mFood += foodProdcer->foodLevel();
+			}
+		}
+	};
+
+	addFoodLevels(NAS2D::Utility<StructureManager>::get().getStructures<CommandCenter>());
+	addFoodLevels(NAS2D::Utility<StructureManager>::get().getStructures<FoodProduction>());
+}
+
+
+void ColonySimulation::transferFoodToCommandCenter()
+{
+	auto& foodProducers = NAS2D::Utility<StructureManager>::get().getStructures<FoodProduction>();
+	auto& commandCenters = NAS2D::Utility<StructureManager>::get().getStructures<CommandCenter>();
+
+	auto foodProducerIterator = foodProducers.begin();
+	for (auto commandCenter : commandCenters)
+	{
+		if (!commandCenter->operational()) { continue; }
+
+		int foodToMove = commandCenter->foodCapacity() - commandCenter->foodLevel();
+
+		while (foodProducerIterator != foodProducers.end())
+		{
+			auto foodProducer = static_cast<FoodProduction*>(*foodProducerIterator);
+			const int foodMoved = std::clamp(foodToMove, 0, foodProducer->foodLevel());
+			foodProducer->foodLevel(foodProducer->foodLevel() - foodMoved);
+			commandCenter->foodLevel(commandCenter->foodLevel() + foodMoved);
+
+			foodToMove -= foodMoved;
+
+			if (foodToMove == 0) { return; }
+
+			++foodProducerIterator;
+		}
+	}
+}
+
+
+/**
+ * Update road intersection patterns
+ */
+void ColonySimulation::updateRoads()
+{
+	auto roads = NAS2D::Utility<StructureManager>::get().getStructures<Road>();
+	const auto surface = mTileMap->tiles(NAS2D::Rectangle<int>::Create({0, 0}, mTileMap->size()), 0);
+
+	for (auto road : roads)
+	{
+		if (road->routeConditionChanged())
+		{
+			tileRouteCostChanged(*road->tile());
+		}
+
+		if (!road->operational()) { continue; }
+
+		const auto tileLocation = NAS2D::Utility<StructureManager>::get().tileFromStructure(road).xy();
+
+		std::array<bool, 4> surroundingTiles{false, false, false, false};
+		for (size_t i = 0; i < 4; ++i)
+		{
+			const auto tileToInspect = tileLocation + DirectionClockwise4[i];
+			if (!surface.contains(tileToInspect)) { continue; }
+			const auto& tile = surface[tileToInspect];
+			if (!tile.thingIsStructure()) { continue; }
+
+			surroundingTiles[i] = tile.structure()->structureId() == StructureID::SID_ROAD;
+		}
+
+		std::string tag = "";
+		
+		if (road->integrity() < constants::RoadIntegrityChange) { tag = "-decayed"; }
+		else if (road->integrity() == 0) { tag = "-destroyed"; }
+
+		road->sprite().play(IntersectionPatternTable.at(surroundingTiles) + tag);
+	}
+}
+
+
+void ColonySimulation::checkAgingStructures()
+{
+	const auto& structures = NAS2D::Utility<StructureManager>::get().agingStructures();
+
+	for (auto structure : structures)
+	{
+		const auto& structureTile = NAS2D::Utility<StructureManager>::get().tileFromStructure(structure);
+
+		if (structure->age() == structure->maxAge() - 10)
+		{
+			mNotificationSignal({
+				"Aging Structure",
+				structure->name() + " is getting old. You should replace it soon.",
+				structureTile.xyz(),
+				NotificationType::Warning});
+		}
+		else if (structure->age() == structure->maxAge() - 5)
+		{
+			mNotificationSignal({
+				"Aging Structure",
+				structure->name() + " is about to collapse. You should replace it right away or consider demolishing it.",
+				structureTile.xyz(),
+				NotificationType::Critical});
+		}
+	}
+}
+
+
+void ColonySimulation::checkNewlyBuiltStructures()
+{
+	const auto& structures = NAS2D::Utility<StructureManager>::get().newlyBuiltStructures();
+
+	for (auto structure : structures)
+	{
+		const auto& structureTile = NAS2D::Utility<StructureManager>::get().tileFromStructure(structure);
+
+		mNotificationSignal({
+			"Construction Finished",
+			structure->name() + " completed construction.",
+			structureTile.xyz(),
+			NotificationType::Information});
+	}
+}
+
+
+void ColonySimulation::updateMaintenance()
+{
+	auto sortLambda = [](const Structure* lhs, const Structure* rhs) -> bool
+	{
+		return lhs->integrity() < rhs->integrity();
+	};
+
+	auto& structureManager = NAS2D::Utility<StructureManager>::get();
+	auto structures = structureManager.allStructures();
+	std::sort(structures.begin(), structures.end(), sortLambda);
+
+	auto& maintenanceFacilities = structureManager.getStructures<MaintenanceFacility>();
+	for (auto maintenanceFacility : maintenanceFacilities)
+	{
+		maintenanceFacility->repairStructures(structures);
+	}
+}
+
+
+void ColonySimulation::addMoraleReason(const std::string& reason, int value)
+{
+	if (value == 0) { return; }
+	mMoraleChanges.push_back(std::make_pair(reason, value));
+}
+
+
+/**
+ * Updates all robots.
+ */
+void ColonySimulation::updateRobots()
+{
+	auto robot_it = mRobotList.begin();
+	while (robot_it != mRobotList.end())
+	{
+		auto robot = robot_it->first;
+		auto tile = robot_it->second;
+
+		robot->update();
+
+		const auto position = tile->xyz();
+
+		pushAgingRobotMessage(robot, position, mNotificationSignal);
+
+		if (robot->dead())
+		{
+			const auto robotLocationText = "(" +  std::to_string(position.xy.x) + ", " + std::to_string(position.xy.y) + ")";
+
+			if (robot->selfDestruct())
+			{
+				mNotificationSignal({
+					"Robot Self-Destructed",
+					robot->name() + " at location " + robotLocationText + " self destructed.",
+					position,
+					NotificationType::Critical});
+			}
+			else if (robot->type() != Robot::Type::Miner)
+			{
+				const auto text = "Your " + robot->name() + " at location " + robotLocationText + " has broken down. It will not be able to complete its task and will be removed from your inventory.";
+				mNotificationSignal({"Robot Broke Down", text, position, NotificationType::Critical});
+				resetTileIndexFromDozer(robot, tile);
+			}
+
+			takeRobotOffTile(*robot, *tile);
+
+			for (auto rcc : NAS2D::Utility<StructureManager>::get().getStructures<RobotCommand>())
+			{
+				rcc->removeRobot(robot);
+			}
+
+			mRobotRemovedSignal(robot);
+
+			mRobotPool.erase(robot);
+			delete robot;
+			robot_it = mRobotList.erase(robot_it);
+		}
+		else if (robot->idle())
+		{
+			if (robot->taskCanceled())
+			{
+				resetTileIndexFromDozer(robot, tile);
+				robot->reset();
+			}
+
+			takeRobotOffTile(*robot, *tile);
+			robot_it = mRobotList.erase(robot_it);
+		}
+		else
+		{
+			++robot_it;
+		}
+	}
+
+	updateRobotControl(mRobotPool);
+}
+
+
+/**
+ * Advances the colony by one turn.
+ */
+void ColonySimulation::nextTurn()
+{
+	mTurnProfiler.beginTurn(mTurnCount + 1);
+
+	mPopulationPool.clear();
+
+	{
+		TurnProfiler::Scope scope{mTurnProfiler, "updateConnectedness"};
+		updateConnectedness();
+	}
+
+	{
+		TurnProfiler::Scope scope{mTurnProfiler, "StructureManager::update"};
+		NAS2D::Utility<StructureManager>::get().update(mPopulationPool);
+	}
+
+	{
+		TurnProfiler::Scope scope{mTurnProfiler, "checkStructures"};
+		checkAgingStructures();
+		checkNewlyBuiltStructures();
+	}
+
+	mPreviousMorale = mCurrentMorale;
+
+	transferFoodToCommandCenter();
+
+	{
+		TurnProfiler::Scope scope{mTurnProfiler, "CrimeRateUpdate"};
+		mCrimeRateUpdate.update(mPoliceCoverage);
+	}
+
+	{
+		TurnProfiler::Scope scope{mTurnProfiler, "CrimeExecution"};
+		auto structuresCommittingCrimes = mCrimeRateUpdate.structuresCommittingCrimes();
+		mCrimeExecution.executeCrimes(structuresCommittingCrimes);
+	}
+
+	{
+		TurnProfiler::Scope scope{mTurnProfiler, "updatePopulation"};
+		updateResidentialCapacity();
+		updateFood();
+		updatePopulation();
+	}
+
+	{
+		TurnProfiler::Scope scope{mTurnProfiler, "updateMaintenance"};
+		updateMaintenance();
+	}
+
+	{
+		TurnProfiler::Scope scope{mTurnProfiler, "updateMorale"};
+		updateCommercial();
+		updateBiowasteRecycling();
+		updateMorale();
+	}
+
+	{
+		TurnProfiler::Scope scope{mTurnProfiler, "updateRobots"};
+		updateRobots();
+	}
+
+	{
+		TurnProfiler::Scope scope{mTurnProfiler, "updateResources"};
+		updateResources();
+	}
+
+	{
+		TurnProfiler::Scope scope{mTurnProfiler, "updateRoads"};
+		updateRoads();
+	}
+
+	{
+		TurnProfiler::Scope scope{mTurnProfiler, "updateCoverage"};
+		updateCommRangeOverlay();
+		updatePoliceOverlay();
+	}
+
+	{
+		TurnProfiler::Scope scope{mTurnProfiler, "factoryProduction"};
+		auto& factories = NAS2D::Utility<StructureManager>::get().getStructures<Factory>();
+		for (auto factory : factories)
+		{
+			factory->updateProduction();
+		}
+	}
+
+	checkColonyShip();
+
+	mTurnCount++;
+}
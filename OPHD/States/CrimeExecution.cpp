@@ -2,13 +2,12 @@
 
 #include "../StructureManager.h"
 #include "../RandomNumberGenerator.h"
-#include "../UI/NotificationArea.h"
 
 #include <NAS2D/StringUtils.h>
 #include <NAS2D/Utility.h>
 
 
-CrimeExecution::CrimeExecution(NotificationArea& notificationArea) : mNotificationArea(notificationArea) {}
+CrimeExecution::CrimeExecution(NotificationSignal& notificationSignal) : mNotificationSignal(notificationSignal) {}
 
 
 void CrimeExecution::executeCrimes(const std::vector<Structure*>& structuresCommittingCrime)
@@ -57,18 +56,20 @@ void CrimeExecution::stealFood(FoodProduction& structure)
 
 		const auto& structureTile = NAS2D::Utility<StructureManager>::get().tileFromStructure(&structure);
 
-		mNotificationArea.push({
+		mNotificationSignal({
 			"Food Stolen",
 			NAS2D::stringFrom(foodStolen) + " units of food was pilfered from a " + structure.name() + ". " + getReasonForStealing() + ".",
 			structureTile.xyz(),
-			NotificationArea::NotificationType::Warning});
+			NotificationType::Warning});
 	}
 }
 
 
 void CrimeExecution::stealRefinedResources(Structure& structure)
 {
+	const auto storedBefore = structure.storage();
 	stealResources(structure, ResourceNamesRefined);
+	NAS2D::Utility<StructureManager>::get().refinedResources().debited(storedBefore - structure.storage());
 }
 
 
@@ -87,7 +88,7 @@ void CrimeExecution::stealResources(Structure& structure, const std::array<std::
 
 	auto resourceIndicesWithStock = structure.storage().getIndicesWithStock();
 
-	auto indexToStealFrom = randomNumber.generate<int>(0, static_cast<int>(resourceIndicesWithStock.size()) - 1);
+	auto indexToStealFrom = randomStreams[RandomStream::CrimeExecution].generate<int>(0, static_cast<int>(resourceIndicesWithStock.size()) - 1);
 
 	int amountStolen = calcAmountForStealing(2, 5);
 	if (amountStolen > structure.storage().resources[indexToStealFrom])
@@ -99,11 +100,11 @@ void CrimeExecution::stealResources(Structure& structure, const std::array<std::
 
 	const auto& structureTile = NAS2D::Utility<StructureManager>::get().tileFromStructure(&structure);
 
-	mNotificationArea.push({
+	mNotificationSignal({
 		"Resources Stolen",
 		NAS2D::stringFrom(amountStolen) + " units of " + resourceNames[indexToStealFrom] + " were stolen from a " + structure.name() + ". " + getReasonForStealing() + ".",
 		structureTile.xyz(),
-		NotificationArea::NotificationType::Warning});
+		NotificationType::Warning});
 }
 
 
@@ -113,17 +114,17 @@ void CrimeExecution::vandalize(Structure& structure)
 
 	const auto& structureTile = NAS2D::Utility<StructureManager>::get().tileFromStructure(&structure);
 
-	mNotificationArea.push({
+	mNotificationSignal({
 		"Vandalism",
 		"A " + structure.name() + " was vandalized.",
 		structureTile.xyz(),
-		NotificationArea::NotificationType::Warning});
+		NotificationType::Warning});
 }
 
 
 int CrimeExecution::calcAmountForStealing(int unadjustedMin, int unadjustedMax)
 {
-	auto amountToSteal = randomNumber.generate(unadjustedMin, unadjustedMax);
+	auto amountToSteal = randomStreams[RandomStream::CrimeExecution].generate(unadjustedMin, unadjustedMax);
 
 	return static_cast<int>(stealingMultipliers.at(mDifficulty) * amountToSteal);
 }
@@ -131,5 +132,5 @@ int CrimeExecution::calcAmountForStealing(int unadjustedMin, int unadjustedMax)
 
 std::string CrimeExecution::getReasonForStealing()
 {
-	return stealingResoureReasons[randomNumber.generate<std::size_t>(0, stealingResoureReasons.size() - 1)];
+	return stealingResoureReasons[randomStreams[RandomStream::CrimeExecution].generate<std::size_t>(0, stealingResoureReasons.size() - 1)];
 }
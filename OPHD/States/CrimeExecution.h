@@ -2,6 +2,9 @@
 
 #include "../Things/Structures/FoodProduction.h"
 #include "../Common.h"
+#include "../Notification.h"
+
+#include <NAS2D/Signal/Signal.h>
 
 #include <vector>
 #include <array>
@@ -10,13 +13,13 @@
 #include <utility>
 
 
-class NotificationArea;
-
-
 class CrimeExecution
 {
 public:
-	CrimeExecution(NotificationArea& notificationArea);
+	using NotificationSignal = NAS2D::Signal<Notification>;
+
+public:
+	CrimeExecution(NotificationSignal& notificationSignal);
 
 	void difficulty(Difficulty difficulty) { mDifficulty = difficulty; }
 
@@ -49,7 +52,7 @@ private:
 	};
 
 	Difficulty mDifficulty{Difficulty::Medium};
-	NotificationArea& mNotificationArea;
+	NotificationSignal& mNotificationSignal;
 	std::vector<std::pair<std::string, int>> mMoraleChanges;
 
 	void stealResources(Structure& structure, const std::array<std::string, 4>& resourceNames);
@@ -1,5 +1,6 @@
 #include "CrimeRateUpdate.h"
 
+#include "../Map/CoverageGrid.h"
 #include "../Map/Tile.h"
 #include "../Things/Structures/Structure.h"
 #include "../StructureManager.h"
@@ -8,7 +9,7 @@
 #include <NAS2D/Utility.h>
 
 
-void CrimeRateUpdate::update(const std::vector<std::vector<Tile*>>& policeOverlays)
+void CrimeRateUpdate::update(const CoverageGrid& policeCoverage)
 {
 	mMeanCrimeRate = 0;
 	mStructuresCommittingCrimes.clear();
@@ -26,13 +27,13 @@ void CrimeRateUpdate::update(const std::vector<std::vector<Tile*>>& policeOverla
 
 	for (auto structure : structuresWithCrime)
 	{
-		int crimeRateChange = isProtectedByPolice(policeOverlays, structure) ? -1 : 1;
+		int crimeRateChange = isProtectedByPolice(policeCoverage, structure) ? -1 : 1;
 		structure->increaseCrimeRate(crimeRateChange);
 
 		// Crime Rate of 0% means no crime
 		// Crime Rate of 100% means crime occurs 10% of the time on medium difficulty
 		// chanceCrimeOccurs multiplier increases or decreases chance based on difficulty
-		if (structure->crimeRate() * chanceCrimeOccurs[mDifficulty] + randomNumber.generate<int>(0, 1000) > 1000)
+		if (structure->crimeRate() * chanceCrimeOccurs[mDifficulty] + randomStreams[RandomStream::CrimeRate].generate<int>(0, 1000) > 1000)
 		{
 			mStructuresCommittingCrimes.push_back(structure);
 		}
@@ -46,19 +47,9 @@ void CrimeRateUpdate::update(const std::vector<std::vector<Tile*>>& policeOverla
 }
 
 
-bool CrimeRateUpdate::isProtectedByPolice(const std::vector<std::vector<Tile*>>& policeOverlays, Structure* structure)
+bool CrimeRateUpdate::isProtectedByPolice(const CoverageGrid& policeCoverage, Structure* structure)
 {
-	const auto& structureTile = NAS2D::Utility<StructureManager>::get().tileFromStructure(structure);
-
-	for (const auto& tile : policeOverlays[structureTile.depth()])
-	{
-		if (tile->xy() == structureTile.xy())
-		{
-			return true;
-		}
-	}
-
-	return false;
+	return policeCoverage.covered(structure->tile()->xyz());
 }
 
 
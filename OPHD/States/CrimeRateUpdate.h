@@ -8,14 +8,14 @@
 #include <utility>
 
 
+class CoverageGrid;
 class Structure;
-class Tile;
 
 
 class CrimeRateUpdate
 {
 public:
-	void update(const std::vector<std::vector<Tile*>>& policeOverlays);
+	void update(const CoverageGrid& policeCoverage);
 
 	int meanCrimeRate() const { return mMeanCrimeRate; }
 	std::vector<std::pair<std::string, int>> moraleChanges() const { return mMoraleChanges; }
@@ -37,7 +37,7 @@ private:
 	std::vector<std::pair<std::string, int>> mMoraleChanges;
 	std::vector<Structure*> mStructuresCommittingCrimes;
 
-	bool isProtectedByPolice(const std::vector<std::vector<Tile*>>& policeOverlays, Structure* structure);
+	bool isProtectedByPolice(const CoverageGrid& policeCoverage, Structure* structure);
 	int calculateMoraleChange();
 	void updateMoraleChanges();
 };
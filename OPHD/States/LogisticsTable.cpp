@@ -0,0 +1,143 @@
+#include "LogisticsTable.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+
+/**
+ * Adds a route, replacing any route the mine already had, and indexes
+ * every tile along it.
+ *
+ * \return	Id of the new route.
+ */
+LogisticsTable::RouteId LogisticsTable::add(MineFacility& mine, OreRefining& smelter, Route route)
+{
+	remove(routeIdFor(mine));
+
+	RouteId id;
+	if (!mFreeIds.empty())
+	{
+		id = mFreeIds.back();
+		mFreeIds.pop_back();
+	}
+	else
+	{
+		id = static_cast<RouteId>(mEntries.size());
+		mEntries.emplace_back();
+	}
+
+	route.forEachTile([this, id](Route::Index tile) { mRoutesByTile[tile].push_back(id); });
+
+	mEntries[id] = {std::move(route), &mine, &smelter};
+	mRouteIds[&mine] = id;
+	return id;
+}
+
+
+/**
+ * Removes a route. Does nothing if there is no route with the id.
+ */
+void LogisticsTable::remove(RouteId id)
+{
+	if (!contains(id)) { return; }
+
+	auto& removed = mEntries[id];
+	removed.route.forEachTile([this, id](Route::Index tile)
+	{
+		const auto it = mRoutesByTile.find(tile);
+		if (it == mRoutesByTile.end()) { return; }
+
+		auto& ids = it->second;
+		ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+		if (ids.empty())
+		{
+			mRoutesByTile.erase(it);
+		}
+	});
+
+	mRouteIds.erase(removed.mine);
+	removed = {};
+	mFreeIds.push_back(id);
+}
+
+
+bool LogisticsTable::contains(RouteId id) const
+{
+	return id < mEntries.size() && mEntries[id].mine != nullptr;
+}
+
+
+const Route& LogisticsTable::route(RouteId id) const
+{
+	return entry(id).route;
+}
+
+
+MineFacility& LogisticsTable::mine(RouteId id) const
+{
+	return *entry(id).mine;
+}
+
+
+OreRefining& LogisticsTable::smelter(RouteId id) const
+{
+	return *entry(id).smelter;
+}
+
+
+/**
+ * \return	Id of the mine's route or NoRoute if it has none.
+ */
+LogisticsTable::RouteId LogisticsTable::routeIdFor(const MineFacility& mine) const
+{
+	const auto it = mRouteIds.find(&mine);
+	return it != mRouteIds.end() ? it->second : NoRoute;
+}
+
+
+/**
+ * \return	Pointer to the mine's route or nullptr if it has none.
+ */
+const Route* LogisticsTable::routeFor(const MineFacility& mine) const
+{
+	const auto id = routeIdFor(mine);
+	return id != NoRoute ? &mEntries[id].route : nullptr;
+}
+
+
+/**
+ * Drops every route that crosses a surface tile.
+ */
+void LogisticsTable::invalidate(Route::Index tile)
+{
+	const auto it = mRoutesByTile.find(tile);
+	if (it == mRoutesByTile.end()) { return; }
+
+	// remove() modifies the index so work from a copy of the ids
+	const auto ids = it->second;
+	for (const auto id : ids)
+	{
+		remove(id);
+	}
+}
+
+
+void LogisticsTable::clear()
+{
+	mEntries.clear();
+	mFreeIds.clear();
+	mRouteIds.clear();
+	mRoutesByTile.clear();
+}
+
+
+const LogisticsTable::Entry& LogisticsTable::entry(RouteId id) const
+{
+	if (!contains(id))
+	{
+		throw std::runtime_error("LogisticsTable: No route with id " + std::to_string(id));
+	}
+	return mEntries[id];
+}
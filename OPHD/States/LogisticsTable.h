@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Route.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+
+class MineFacility;
+class OreRefining;
+
+
+/**
+ * Truck routes from mines to smelters.
+ *
+ * Each route gets an id that stays valid until the route is removed, so
+ * the trucking overlay, the minimap and ore transport all refer to the
+ * one copy held here. Ids of removed routes are reused.
+ *
+ * A mine has at most one route. Routes are kept until a tile they cross
+ * changes: a reverse index from each tile to the routes crossing it means
+ * invalidate() only drops the routes that use that tile. Anything that
+ * changes what a truck pays to cross a tile, like a structure being placed
+ * or removed, a road wearing down or terrain being dozed, has to be
+ * reported with invalidate().
+ */
+class LogisticsTable
+{
+public:
+	using RouteId = std::uint32_t;
+
+	static constexpr RouteId NoRoute = static_cast<RouteId>(-1);
+
+public:
+	LogisticsTable() = default;
+
+	LogisticsTable(const LogisticsTable&) = delete;
+	LogisticsTable& operator=(const LogisticsTable&) = delete;
+
+	RouteId add(MineFacility& mine, OreRefining& smelter, Route route);
+	void remove(RouteId id);
+
+	bool contains(RouteId id) const;
+	const Route& route(RouteId id) const;
+	MineFacility& mine(RouteId id) const;
+	OreRefining& smelter(RouteId id) const;
+
+	RouteId routeIdFor(const MineFacility& mine) const;
+	const Route* routeFor(const MineFacility& mine) const;
+
+	void invalidate(Route::Index tile);
+	void clear();
+
+	std::size_t size() const { return mRouteIds.size(); }
+
+	/**
+	 * Calls function(RouteId, const Route&) for every route, in id order.
+	 */
+	template <typename Function>
+	void forEachRoute(Function function) const
+	{
+		for (std::size_t id = 0; id < mEntries.size(); ++id)
+		{
+			if (mEntries[id].mine) { function(static_cast<RouteId>(id), mEntries[id].route); }
+		}
+	}
+
+private:
+	struct Entry
+	{
+		Route route;
+		MineFacility* mine{nullptr};
+		OreRefining* smelter{nullptr};
+	};
+
+	const Entry& entry(RouteId id) const;
+
+	std::vector<Entry> mEntries;
+	std::vector<RouteId> mFreeIds;
+	std::map<const MineFacility*, RouteId> mRouteIds;
+	std::unordered_map<Route::Index, std::vector<RouteId>> mRoutesByTile;
+};
@@ -2,7 +2,6 @@
 
 #include "MainMenuState.h"
 #include "MainReportsUiState.h"
-#include "Route.h"
 
 #include "../Constants/Numbers.h"
 #include "../Constants/Strings.h"
@@ -10,7 +9,6 @@
 
 #include "../DirectionOffset.h"
 #include "../Cache.h"
-#include "../GraphWalker.h"
 #include "../StructureCatalogue.h"
 #include "../StructureManager.h"
 
@@ -22,11 +20,12 @@
 
 #include <NAS2D/Utility.h>
 #include <NAS2D/EventHandler.h>
+#include <NAS2D/Filesystem.h>
 #include <NAS2D/Renderer/Renderer.h>
-#include <NAS2D/Math/PointInRectangleRange.h>
 
 #include <algorithm>
 #include <sstream>
+#include <string>
 #include <vector>
 
 // Disable some warnings that can be safely ignored.
@@ -44,14 +43,6 @@ const NAS2D::Font* MAIN_FONT = nullptr;
 
 namespace
 {
-	// Relative proportion of mines with yields {low, med, high}
-	const std::map<Planet::Hostility, std::array<int, 3>> HostilityMineYields =
-	{
-		{Planet::Hostility::Low, {30, 50, 20}},
-		{Planet::Hostility::Medium, {45, 35, 20}},
-		{Planet::Hostility::High, {35, 20, 45}},
-	};
-
 	struct RobotMeta
 	{
 		std::string name;
@@ -64,138 +55,43 @@ namespace
 		{Robot::Type::Dozer, RobotMeta{constants::Robodozer, constants::RobodozerSheetId}},
 		{Robot::Type::Miner, RobotMeta{constants::Robominer, constants::RobominerSheetId}}
 	};
-
-
-	NAS2D::Point<int> clampPointToRect(NAS2D::Point<int> point, const NAS2D::Rectangle<int>& rect)
-	{
-		const auto endPoint = rect.endPoint();
-		return {
-			std::clamp(point.x, rect.x, endPoint.x),
-			std::clamp(point.y, rect.y, endPoint.y),
-		};
-	}
-
-
-	NAS2D::Rectangle<int> buildAreaRectFromCenter(const NAS2D::Point<int>& centerPoint, int radius)
-	{
-		const auto mapRect = NAS2D::Rectangle{0, 0, 299, 149};
-		const auto offset = NAS2D::Vector{radius, radius};
-		const auto areaStartPoint = clampPointToRect(centerPoint - offset, mapRect);
-		const auto areaEndPoint = clampPointToRect(centerPoint + offset + NAS2D::Vector{1, 1}, mapRect);
-		return NAS2D::Rectangle<int>::Create(areaStartPoint, areaEndPoint);
-	}
-
-
-	void fillOverlayCircle(TileMap& tileMap, std::vector<Tile*>& tileList, Tile& centerTile, int range)
-	{
-		const auto center = centerTile.xy();
-		const auto depth = centerTile.depth();
-		auto area = buildAreaRectFromCenter(center, range);
-
-		for (const auto point : NAS2D::PointInRectangleRange(area))
-		{
-			if (isPointInRange(center, point, range))
-			{
-				auto& tile = tileMap.getTile({point, depth});
-				if (std::find(tileList.begin(), tileList.end(), &tile) == tileList.end())
-				{
-					tileList.push_back(&tile);
-				}
-			}
-		}
-	}
-
-
-	template <typename StructureType>
-	void fillOverlay(TileMap& tileMap, std::vector<Tile*>& overlay, const std::vector<StructureType*> structures)
-	{
-		auto& structureManager = NAS2D::Utility<StructureManager>::get();
-		for (auto structure : structures)
-		{
-			if (!structure->operational()) { continue; }
-			auto& centerTile = structureManager.tileFromStructure(structure);
-			fillOverlayCircle(tileMap, overlay, centerTile, structure->getRange());
-		}
-	}
-
-
-	template <typename StructureType>
-	void fillOverlay(TileMap& tileMap, std::vector<std::vector<Tile*>>& overlays, const std::vector<StructureType*> structures)
-	{
-		auto& structureManager = NAS2D::Utility<StructureManager>::get();
-		for (auto structure : structures)
-		{
-			if (!structure->operational()) { continue; }
-			auto& centerTile = structureManager.tileFromStructure(structure);
-			fillOverlayCircle(tileMap, overlays[centerTile.depth()], centerTile, structure->getRange());
-		}
-	}
-
-
-	void pushAgingRobotMessage(const Robot* robot, const MapCoordinate& position, NotificationArea& notificationArea)
-	{
-		const auto robotLocationText = "(" + std::to_string(position.xy.x) + ", " + std::to_string(position.xy.y) + ")";
-
-		if (robot->fuelCellAge() == 190) /// \fixme magic number
-		{
-			notificationArea.push({
-				"Aging Robot",
-				"Robot '" + robot->name() + "' at location " + robotLocationText + " is approaching its maximum age.",
-				position,
-				NotificationArea::NotificationType::Warning});
-		}
-		else if (robot->fuelCellAge() == 195) /// \fixme magic number
-		{
-			notificationArea.push({
-				"Aging Robot",
-				"Robot '" + robot->name() + "' at location " + robotLocationText + " will fail in a few turns. Replace immediately.",
-				position,
-				NotificationArea::NotificationType::Critical});
-		}
-	}
 }
 
 
 MapViewState::MapViewState(MainReportsUiState& mainReportsState, const std::string& savegame) :
 	mMainReportsState(mainReportsState),
-	mCrimeExecution(mNotificationArea),
 	mTechnologyReader("tech0-1.xml"),
 	mLoadingExisting(true),
 	mExistingToLoad(savegame),
-	mResourceInfoBar{mResourcesCount, mPopulation, mCurrentMorale, mPreviousMorale, mFood},
-	mRobotDeploymentSummary{mRobotPool}
+	mResourceInfoBar{mColonySimulation.resources(), mColonySimulation.population(), mColonySimulation.morale(), mColonySimulation.previousMorale(), mColonySimulation.food()},
+	mRobotDeploymentSummary{mColonySimulation.robotPool()}
 {
-	ccLocation() = CcNotPlaced;
+	mColonySimulation.notification().connect(&mNotificationArea, &NotificationArea::push);
+	mColonySimulation.robotRemoved().connect(this, &MapViewState::onRobotRemoved);
 	NAS2D::Utility<NAS2D::EventHandler>::get().windowResized().connect(this, &MapViewState::onWindowResized);
 }
 
 
 MapViewState::MapViewState(MainReportsUiState& mainReportsState, const Planet::Attributes& planetAttributes, Difficulty selectedDifficulty) :
 	mMainReportsState(mainReportsState),
-	mTileMap(new TileMap(planetAttributes.mapImagePath, planetAttributes.maxDepth, planetAttributes.maxMines, HostilityMineYields.at(planetAttributes.hostility))),
+	mColonySimulation(planetAttributes, selectedDifficulty),
+	mTileMap(mColonySimulation.tileMap()),
 	mMapView{std::make_unique<MapView>(*mTileMap)},
-	mCrimeExecution(mNotificationArea),
 	mTechnologyReader("tech0-1.xml"),
-	mPlanetAttributes(planetAttributes),
-	mResourceInfoBar{mResourcesCount, mPopulation, mCurrentMorale, mPreviousMorale, mFood},
-	mRobotDeploymentSummary{mRobotPool},
-	mMiniMap{std::make_unique<MiniMap>(*mMapView, mTileMap, mRobotList, planetAttributes.mapImagePath)},
+	mResourceInfoBar{mColonySimulation.resources(), mColonySimulation.population(), mColonySimulation.morale(), mColonySimulation.previousMorale(), mColonySimulation.food()},
+	mRobotDeploymentSummary{mColonySimulation.robotPool()},
+	mMiniMap{std::make_unique<MiniMap>(*mMapView, mTileMap, mColonySimulation.robotList(), planetAttributes.mapImagePath)},
 	mDetailMap{std::make_unique<DetailMap>(*mMapView, *mTileMap, planetAttributes.tilesetPath)},
 	mNavControl{std::make_unique<NavControl>(*mMapView, *mTileMap)}
 {
-	difficulty(selectedDifficulty);
-	ccLocation() = CcNotPlaced;
+	mColonySimulation.notification().connect(&mNotificationArea, &NotificationArea::push);
+	mColonySimulation.robotRemoved().connect(this, &MapViewState::onRobotRemoved);
 	NAS2D::Utility<NAS2D::EventHandler>::get().windowResized().connect(this, &MapViewState::onWindowResized);
 }
 
 
 MapViewState::~MapViewState()
 {
-	delete mPathSolver;
-
-	scrubRobotList();
-	delete mTileMap;
-
 	NAS2D::Utility<NAS2D::Renderer>::get().setCursor(PointerType::POINTER_NORMAL);
 
 	auto& eventHandler = NAS2D::Utility<NAS2D::EventHandler>::get();
@@ -209,15 +105,13 @@ MapViewState::~MapViewState()
 	eventHandler.windowResized().disconnect(this, &MapViewState::onWindowResized);
 
 	eventHandler.textInputMode(false);
-
-	NAS2D::Utility<std::map<class MineFacility*, Route>>::get().clear();
 }
 
 
 void MapViewState::setPopulationLevel(PopulationLevel popLevel)
 {
-	mLandersColonist = static_cast<int>(popLevel);
-	mLandersCargo = 2; ///\todo This should be set based on difficulty level.
+	mColonySimulation.colonistLanders(static_cast<int>(popLevel));
+	mColonySimulation.cargoLanders(2); ///\todo This should be set based on difficulty level.
 }
 
 
@@ -232,20 +126,12 @@ void MapViewState::initialize()
 
 	renderer.setCursor(PointerType::POINTER_NORMAL);
 
-	mPopulationPool.population(&mPopulation);
-
 	if (mLoadingExisting)
 	{
 		load(mExistingToLoad);
 	}
-	else
-	{
-		// StructureCatalogue is initialized in load routine if saved game present to load existing structures
-		StructureCatalogue::init(mPlanetAttributes.meanSolarDistance);
-	}
 
 	setupUiPositions(renderer.size());
-	resetPoliceOverlays();
 
 	NAS2D::Utility<NAS2D::Renderer>::get().fadeIn(constants::FadeSpeed);
 
@@ -262,9 +148,6 @@ void MapViewState::initialize()
 	eventHandler.textInputMode(true);
 
 	MAIN_FONT = &fontCache.load(constants::FONT_PRIMARY, constants::FontPrimaryNormal);
-
-	delete mPathSolver;
-	mPathSolver = new micropather::MicroPather(mTileMap, 250, 6, false);
 }
 
 
@@ -290,14 +173,6 @@ void MapViewState::focusOnStructure(Structure* structure)
 }
 
 
-void MapViewState::difficulty(Difficulty difficulty)
-{
-	mDifficulty = difficulty;
-	mCrimeRateUpdate.difficulty(difficulty);
-	mCrimeExecution.difficulty(difficulty);
-}
-
-
 /**
  * Updates the entire state of the game.
  */
@@ -337,24 +212,6 @@ NAS2D::State* MapViewState::update()
 }
 
 
-void MapViewState::updatePlayerResources()
-{
-	auto& storageTanks = NAS2D::Utility<StructureManager>::get().getStructures<StorageTanks>();
-	auto& command = NAS2D::Utility<StructureManager>::get().getStructures<CommandCenter>();
-
-	std::vector<Structure*> storage;
-	storage.insert(storage.end(), command.begin(), command.end());
-	storage.insert(storage.end(), storageTanks.begin(), storageTanks.end());
-
-	StorableResources resources;
-	for (auto structure : storage)
-	{
-		resources += structure->storage();
-	}
-	mResourcesCount = resources;
-}
-
-
 /**
  * Window activation handler.
  */
@@ -454,11 +311,27 @@ void MapViewState::onKeyDown(NAS2D::EventHandler::KeyCode key, NAS2D::EventHandl
 			{
 				StorableResources resourcesToAdd{1000, 1000, 1000, 1000};
 				addRefinedResources(resourcesToAdd);
-				updatePlayerResources();
+				mColonySimulation.updatePlayerResources();
 				updateStructuresAvailability();
 			}
 			break;
 
+		case NAS2D::EventHandler::KeyCode::KEY_F9:
+			if (NAS2D::Utility<NAS2D::EventHandler>::get().control(mod))
+			{
+				NAS2D::Utility<NAS2D::Filesystem>::get().write(constants::TurnProfilePath, mColonySimulation.turnProfiler().toCsv());
+				mNotificationArea.push({
+					"Turn profile saved",
+					"Turn timings for the last " + std::to_string(mColonySimulation.turnProfiler().history().size()) + " turns were written to " + constants::TurnProfilePath + ".",
+					{{-1, -1}, 0},
+					NotificationType::Information});
+			}
+			else
+			{
+				mShowTurnProfile = !mShowTurnProfile;
+			}
+			break;
+
 		case NAS2D::EventHandler::KeyCode::KEY_F2:
 			mFileIoDialog.scanDirectory(constants::SaveGamePath);
 			mFileIoDialog.setMode(FileIo::FileOperation::Save);
@@ -745,17 +618,6 @@ void MapViewState::clearMode()
 }
 
 
-void MapViewState::insertTube(ConnectorDir dir, int depth, Tile& tile)
-{
-	if (dir == ConnectorDir::CONNECTOR_VERTICAL)
-	{
-		throw std::runtime_error("MapViewState::insertTube() called with invalid ConnectorDir paramter.");
-	}
-
-	NAS2D::Utility<StructureManager>::get().addStructure(*new Tube(dir, depth != 0), tile);
-}
-
-
 void MapViewState::placeTubes(Tile& tile)
 {
 	if (!tile.bulldozed()) {
@@ -772,11 +634,8 @@ void MapViewState::placeTubes(Tile& tile)
 
 	if (validTubeConnection(*mTileMap, mMouseTilePosition, cd))
 	{
-		insertTube(cd, mMapView->currentDepth(), mTileMap->getTile(mMouseTilePosition));
-
-		// FIXME: Naive approach -- will be slow with larger colonies.
-		NAS2D::Utility<StructureManager>::get().disconnectAll();
-		updateConnectedness();
+		mColonySimulation.insertTube(cd, mMapView->currentDepth(), mTileMap->getTile(mMouseTilePosition));
+		mColonySimulation.updateConnectedness();
 	}
 	else
 	{
@@ -840,11 +699,11 @@ void MapViewState::placeStructure(Tile& tile)
 		if (!validLanderSite(tile)) { return; }
 
 		auto& s = *new ColonistLander(&tile);
-		s.deploySignal().connect(this, &MapViewState::onDeployColonistLander);
+		s.deploySignal().connect(&mColonySimulation, &ColonySimulation::onDeployColonistLander);
 		NAS2D::Utility<StructureManager>::get().addStructure(s, tile);
 
-		--mLandersColonist;
-		if (mLandersColonist == 0)
+		mColonySimulation.colonistLanders(mColonySimulation.colonistLanders() - 1);
+		if (mColonySimulation.colonistLanders() == 0)
 		{
 			clearMode();
 			resetUi();
@@ -856,11 +715,11 @@ void MapViewState::placeStructure(Tile& tile)
 		if (!validLanderSite(tile)) { return; }
 
 		auto& cargoLander = *new CargoLander(&tile);
-		cargoLander.deploySignal().connect(this, &MapViewState::onDeployCargoLander);
+		cargoLander.deploySignal().connect(&mColonySimulation, &ColonySimulation::onDeployCargoLander);
 		NAS2D::Utility<StructureManager>::get().addStructure(cargoLander, tile);
 
-		--mLandersCargo;
-		if (mLandersCargo == 0)
+		mColonySimulation.cargoLanders(mColonySimulation.cargoLanders() - 1);
+		if (mColonySimulation.cargoLanders() == 0)
 		{
 			clearMode();
 			resetUi();
@@ -876,9 +735,10 @@ void MapViewState::placeStructure(Tile& tile)
 		}
 
 		// Check build cost
-		if (!StructureCatalogue::canBuild(mResourcesCount, mCurrentStructure))
+		auto& resources = mColonySimulation.resources();
+		if (!StructureCatalogue::canBuild(resources, mCurrentStructure))
 		{
-			resourceShortageMessage(mResourcesCount, mCurrentStructure);
+			resourceShortageMessage(resources, mCurrentStructure);
 			return;
 		}
 
@@ -888,18 +748,18 @@ void MapViewState::placeStructure(Tile& tile)
 		if (structure.isFactory())
 		{
 			auto& factory = static_cast<Factory&>(structure);
-			factory.productionComplete().connect(this, &MapViewState::onFactoryProductionComplete);
-			factory.resourcePool(&mResourcesCount);
+			factory.productionComplete().connect(&mColonySimulation, &ColonySimulation::onFactoryProductionComplete);
+			factory.resourcePool(&resources);
 		}
 
 		if (structure.structureId() == StructureID::SID_MAINTENANCE_FACILITY)
 		{
-			static_cast<MaintenanceFacility&>(structure).resources(mResourcesCount);
+			static_cast<MaintenanceFacility&>(structure).resources(resources);
 		}
 
 		auto cost = StructureCatalogue::costToBuild(mCurrentStructure);
 		removeRefinedResources(cost);
-		updatePlayerResources();
+		mColonySimulation.updatePlayerResources();
 		updateStructuresAvailability();
 	}
 }
@@ -908,9 +768,9 @@ void MapViewState::placeStructure(Tile& tile)
 void MapViewState::placeRobot(Tile& tile)
 {
 	if (!tile.excavated()) { return; }
-	if (!mRobotPool.robotCtrlAvailable()) { return; }
+	if (!mColonySimulation.robotPool().robotCtrlAvailable()) { return; }
 
-	if (!inCommRange(tile.xy()))
+	if (!inCommRange(mColonySimulation.commRangeCoverage(), tile.xy()))
 	{
 		doAlertMessage(constants::AlertInvalidRobotPlacement, constants::AlertOutOfCommRange);
 		return;
@@ -935,7 +795,8 @@ void MapViewState::placeRobot(Tile& tile)
 
 void MapViewState::placeRobodozer(Tile& tile)
 {
-	auto& robot = mRobotPool.getDozer();
+	auto& robotPool = mColonySimulation.robotPool();
+	auto& robot = robotPool.getDozer();
 
 	if (tile.thing() && !tile.thingIsStructure())
 	{
@@ -992,11 +853,11 @@ void MapViewState::placeRobodozer(Tile& tile)
 					"Cannot bulldoze",
 					"Cannot bulldoze Robot Command Center by a Robot under its command.",
 					tile.xyz(),
-					NotificationArea::NotificationType::Information});
+					NotificationType::Information});
 			}
 			else
 			{
-				deleteRobotsInRCC(rcc, mRobotPool, mRobotList);
+				deleteRobotsInRCC(rcc, robotPool, mColonySimulation.robotList());
 			}
 		}
 
@@ -1011,16 +872,6 @@ void MapViewState::placeRobodozer(Tile& tile)
 			else { return; }
 		}
 
-		if (structure->structureClass() == Structure::StructureClass::Communication)
-		{
-			updateCommRangeOverlay();
-		}
-		if (structure->structureClass() == Structure::StructureClass::SurfacePolice ||
-			structure->structureClass() == Structure::StructureClass::UndergroundPolice)
-		{
-			updatePoliceOverlay();
-		}
-
 		const auto recycledResources = StructureCatalogue::recyclingValue(structure->structureId());
 		const auto wastedResources = addRefinedResources(recycledResources);
 
@@ -1033,27 +884,25 @@ void MapViewState::placeRobodozer(Tile& tile)
 				"Resources wasted",
 				"Resources wasted demolishing " + structure->name(),
 				tile.xyz(),
-				NotificationArea::NotificationType::Warning});
+				NotificationType::Warning});
 		}
 
-		updatePlayerResources();
+		mColonySimulation.updatePlayerResources();
 		updateStructuresAvailability();
 
-		tile.connected(false);
 		NAS2D::Utility<StructureManager>::get().removeStructure(*structure);
 		tile.deleteThing();
-		NAS2D::Utility<StructureManager>::get().disconnectAll();
 		robot.tileIndex(static_cast<std::size_t>(TerrainType::Dozed));
-		updateConnectedness();
+		mColonySimulation.updateConnectedness();
 	}
 
 	int taskTime = tile.index() == TerrainType::Dozed ? 1 : static_cast<int>(tile.index());
 	robot.startTask(taskTime);
-	mRobotPool.insertRobotIntoTable(mRobotList, robot, tile);
+	mColonySimulation.deployRobot(robot, tile);
 	robot.tileIndex(static_cast<std::size_t>(tile.index()));
-	tile.index(TerrainType::Dozed);
+	mColonySimulation.dozeTile(tile);
 
-	if (!mRobotPool.robotAvailable(Robot::Type::Dozer))
+	if (!robotPool.robotAvailable(Robot::Type::Dozer))
 	{
 		mRobots.removeItem(constants::Robodozer);
 		clearMode();
@@ -1086,7 +935,7 @@ void MapViewState::placeRobodigger(Tile& tile)
 			"Mine destroyed",
 			"Digger destroyed a Mine at (" + std::to_string(position.x) + ", " + std::to_string(position.y) + ").",
 			tile.xyz(),
-			NotificationArea::NotificationType::Information});
+			NotificationType::Information});
 		mTileMap->removeMineLocation(position);
 	}
 
@@ -1159,12 +1008,13 @@ void MapViewState::placeRobominer(Tile& tile)
 		return;
 	}
 
-	auto& robot = mRobotPool.getMiner();
+	auto& robotPool = mColonySimulation.robotPool();
+	auto& robot = robotPool.getMiner();
 	robot.startTask(constants::MinerTaskTime);
-	mRobotPool.insertRobotIntoTable(mRobotList, robot, tile);
-	tile.index(TerrainType::Dozed);
+	mColonySimulation.deployRobot(robot, tile);
+	mColonySimulation.dozeTile(tile);
 
-	if (!mRobotPool.robotAvailable(Robot::Type::Miner))
+	if (!robotPool.robotAvailable(Robot::Type::Miner))
 	{
 		mRobots.removeItem(constants::Robominer);
 		clearMode();
@@ -1172,26 +1022,6 @@ void MapViewState::placeRobominer(Tile& tile)
 }
 
 
-Robot& MapViewState::addRobot(Robot::Type type)
-{
-	const std::map<Robot::Type, void (MapViewState::*)(Robot*)> RobotTypeToHandler
-	{
-		{Robot::Type::Digger, &MapViewState::onDiggerTaskComplete},
-		{Robot::Type::Dozer, &MapViewState::onDozerTaskComplete},
-		{Robot::Type::Miner, &MapViewState::onMinerTaskComplete},
-	};
-
-	if (RobotTypeToHandler.find(type) == RobotTypeToHandler.end())
-	{
-		throw std::runtime_error("Unknown Robot::Type: " + std::to_string(static_cast<int>(type)));
-	}
-
-	auto& robot = mRobotPool.addRobot(type);
-	robot.taskComplete().connect(this, RobotTypeToHandler.at(type));
-	return robot;
-}
-
-
 /**
  * Checks the robot selection interface and if the robot is not available in it, adds
  * it back in.
@@ -1202,7 +1032,7 @@ void MapViewState::populateRobotMenu()
 
 	for (auto& [robotType, robotMeta] : RobotMetaTable)
 	{
-		if (mRobotPool.robotAvailable(robotType))
+		if (mColonySimulation.robotPool().robotAvailable(robotType))
 		{
 			mRobots.addItem({robotMeta.name, robotMeta.sheetIndex, static_cast<int>(robotType)});
 		}
@@ -1228,7 +1058,7 @@ void MapViewState::insertSeedLander(NAS2D::Point<int> point)
 		}
 
 		auto& s = *new SeedLander(point);
-		s.deploySignal().connect(this, &MapViewState::onDeploySeedLander);
+		s.deploySignal().connect(&mColonySimulation, &ColonySimulation::onDeploySeedLander);
 		NAS2D::Utility<StructureManager>::get().addStructure(s, mTileMap->getTile({point, 0})); // Can only ever be placed on depth level 0
 
 		clearMode();
@@ -1245,79 +1075,11 @@ void MapViewState::insertSeedLander(NAS2D::Point<int> point)
 
 
 /**
- * Updates all robots.
+ * Called by the simulation right before a Robot is deleted.
  */
-void MapViewState::updateRobots()
+void MapViewState::onRobotRemoved(Robot* robot)
 {
-	auto robot_it = mRobotList.begin();
-	while (robot_it != mRobotList.end())
-	{
-		auto robot = robot_it->first;
-		auto tile = robot_it->second;
-
-		robot->update();
-
-		const auto position = tile->xyz();
-
-		pushAgingRobotMessage(robot, position, mNotificationArea);
-
-		if (robot->dead())
-		{
-			const auto robotLocationText = "(" +  std::to_string(position.xy.x) + ", " + std::to_string(position.xy.y) + ")";
-
-			if (robot->selfDestruct())
-			{
-				mNotificationArea.push({
-					"Robot Self-Destructed",
-					robot->name() + " at location " + robotLocationText + " self destructed.",
-					position,
-					NotificationArea::NotificationType::Critical});
-			}
-			else if (robot->type() != Robot::Type::Miner)
-			{
-				const auto text = "Your " + robot->name() + " at location " + robotLocationText + " has broken down. It will not be able to complete its task and will be removed from your inventory.";
-				mNotificationArea.push({"Robot Broke Down", text, position, NotificationArea::NotificationType::Critical});
-				resetTileIndexFromDozer(robot, tile);
-			}
-
-			if (tile->thing() == robot)
-			{
-				tile->removeThing();
-			}
-
-			for (auto rcc : NAS2D::Utility<StructureManager>::get().getStructures<RobotCommand>())
-			{
-				rcc->removeRobot(robot);
-			}
-
-			if (mRobotInspector.focusedRobot() == robot) { mRobotInspector.hide(); }
-
-			mRobotPool.erase(robot);
-			delete robot;
-			robot_it = mRobotList.erase(robot_it);
-		}
-		else if (robot->idle())
-		{
-			if (tile->thing() == robot)
-			{
-				tile->removeThing();
-			}
-			robot_it = mRobotList.erase(robot_it);
-
-			if (robot->taskCanceled())
-			{
-				resetTileIndexFromDozer(robot, tile);
-				populateRobotMenu();
-				robot->reset();
-			}
-		}
-		else
-		{
-			++robot_it;
-		}
-	}
-
-	updateRobotControl(mRobotPool);
+	if (mRobotInspector.focusedRobot() == robot) { mRobotInspector.hide(); }
 }
 
 
@@ -1337,75 +1099,3 @@ void MapViewState::setStructureID(StructureID type, InsertMode mode)
 	mInsertMode = mode;
 	NAS2D::Utility<NAS2D::Renderer>::get().setCursor(PointerType::POINTER_PLACE_TILE);
 }
-
-
-/**
- * Checks the connectedness of all tiles surrounding
- * the Command Center.
- */
-void MapViewState::updateConnectedness()
-{
-	if (ccLocation() == CcNotPlaced)
-	{
-		return;
-	}
-
-	// Assumes that the 'thing' at mCCLocation is in fact a Structure.
-	auto& tile = mTileMap->getTile({ccLocation(), 0});
-	Structure* cc = tile.structure();
-
-	if (!cc)
-	{
-		throw std::runtime_error("CC coordinates do not actually point to a Command Center.");
-	}
-
-	if (cc->state() == StructureState::UnderConstruction)
-	{
-		return;
-	}
-
-	tile.connected(true);
-
-	// Start graph walking at the CC location.
-	mConnectednessOverlay.clear();
-	GraphWalker graphWalker({ccLocation(), 0}, *mTileMap, mConnectednessOverlay);
-}
-
-
-void MapViewState::updateCommRangeOverlay()
-{
-	mCommRangeOverlay.clear();
-
-	auto& structureManager = NAS2D::Utility<StructureManager>::get();
-	fillOverlay(*mTileMap, mCommRangeOverlay, structureManager.getStructures<CommandCenter>());
-	fillOverlay(*mTileMap, mCommRangeOverlay, structureManager.getStructures<CommTower>());
-}
-
-
-void MapViewState::updatePoliceOverlay()
-{
-	resetPoliceOverlays();
-
-	auto& structureManager = NAS2D::Utility<StructureManager>::get();
-	fillOverlay(*mTileMap, mPoliceOverlays[0], structureManager.getStructures<SurfacePolice>());
-	fillOverlay(*mTileMap, mPoliceOverlays, structureManager.getStructures<UndergroundPolice>());
-}
-
-
-void MapViewState::resetPoliceOverlays()
-{
-	mPoliceOverlays = std::vector<std::vector<Tile*>>(mTileMap->maxDepth() + 1);
-}
-
-
-/**
- * Removes deployed robots from the TileMap to
- * prevent dangling pointers. Yay for raw memory!
- */
-void MapViewState::scrubRobotList()
-{
-	for (auto it : mRobotList)
-	{
-		it.second->removeThing();
-	}
-}
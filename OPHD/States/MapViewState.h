@@ -1,8 +1,7 @@
 #pragma once
 
 #include "Wrapper.h"
-#include "CrimeRateUpdate.h"
-#include "CrimeExecution.h"
+#include "ColonySimulation.h"
 #include "StructureTracker.h"
 
 #include "Planet.h"
@@ -11,12 +10,7 @@
 #include "../Constants/UiConstants.h"
 
 #include "../Common.h"
-#include "../StorableResources.h"
-#include "../RobotPool.h"
-#include "../PopulationPool.h"
-#include "../Population/Population.h"
 
-#include "../Technology/ResearchTracker.h"
 #include "../Technology/TechnologyCatalog.h"
 
 #include "../Things/Robots/Robot.h"
@@ -64,11 +58,6 @@ namespace NAS2D
 	}
 }
 
-namespace micropather
-{
-	class MicroPather;
-}
-
 struct MapCoordinate;
 class Tile;
 class TileMap;
@@ -91,9 +80,6 @@ enum class InsertMode
 	Structure
 };
 
-using RobotTileTable = std::map<Robot*, Tile*>;
-
-
 class MapViewState : public Wrapper
 {
 public:
@@ -121,9 +107,6 @@ public:
 
 	void focusOnStructure(Structure* s);
 
-	Difficulty difficulty() { return mDifficulty; }
-	void difficulty(Difficulty difficulty);
-
 protected:
 	void initialize() override;
 	State* update() override;
@@ -151,21 +134,15 @@ private:
 
 	void onSystemMenu();
 
-	// ROBOT EVENT HANDLERS
-	void onDozerTaskComplete(Robot* robot);
-	void onDiggerTaskComplete(Robot* robot);
-	void onMinerTaskComplete(Robot* robot);
+	void onRobotRemoved(Robot* robot);
 
 	// DRAWING FUNCTIONS
 	void drawUI();
 	void drawSystemButton() const;
+	void drawTurnProfile() const;
 
 	// INSERT OBJECT HANDLING
-	void onDeployCargoLander();
-	void onDeployColonistLander();
-	void onDeploySeedLander(NAS2D::Point<int> point);
 	void insertSeedLander(NAS2D::Point<int> point);
-	void insertTube(ConnectorDir dir, int depth, Tile& tile);
 
 	void placeTubes(Tile& tile);
 	void placeStructure(Tile& tile);
@@ -175,60 +152,20 @@ private:
 	void placeRobodigger(Tile&);
 	void placeRobominer(Tile&);
 
-	Robot& addRobot(Robot::Type type);
-
 	void setStructureID(StructureID type, InsertMode mode);
 
 	// MISCELLANEOUS UTILITY FUNCTIONS
-	void updateFood();
-	void transferFoodToCommandCenter();
-
-	void updateCommRangeOverlay();
-	void updatePoliceOverlay();
-	void resetPoliceOverlays();
-	void updateConnectedness();
 	void changeViewDepth(int);
 
-	void pullRobotFromFactory(ProductType pt, Factory& factory);
-	void onFactoryProductionComplete(Factory& factory);
-
-	void onMineFacilityExtend(MineFacility* mf);
-
-	void updatePlayerResources();
 	void updateResearch();
+	void updateMoraleReasons();
 
 	// TURN LOGIC
-	void checkColonyShip();
 	void nextTurn();
-	void updatePopulation();
-	void updateCommercial();
-	void updateMaintenance();
-	void updateMorale();
-	void updateResidentialCapacity();
-	void updateBiowasteRecycling();
-	void updateResources();
-	void updateRoads();
-	void updateRobots();
-
-	void findMineRoutes();
-	void transportOreFromMines();
-	void transportResourcesToStorage();
-
-	void checkAgingStructures();
-	void checkNewlyBuiltStructures();
 
 	// SAVE GAME MANAGEMENT FUNCTIONS
-	std::map<int, Robot*> readRobots(NAS2D::Xml::XmlElement* element);
-	void readStructures(NAS2D::Xml::XmlElement* element, const std::map<int, Robot*>& idToRobotMap);
-	void readTurns(NAS2D::Xml::XmlElement* element);
-	void readPopulation(NAS2D::Xml::XmlElement* element);
-	void readMoraleChanges(NAS2D::Xml::XmlElement*);
-
-	void scrubRobotList();
-
 	void load(const std::string& filePath);
 	void save(const std::string& filePath);
-	NAS2D::Xml::XmlElement* serializeProperties();
 
 	// UI MANAGEMENT FUNCTIONS
 	void clearMode();
@@ -250,9 +187,10 @@ private:
 
 	// UI EVENT HANDLERS
 	void onTurns();
-	void setOverlay(std::vector<Tile*>& tileList, Tile::Overlay overlay);
+	void setOverlay(const std::vector<Tile*>& tileList, Tile::Overlay overlay);
+	void setRouteOverlay(const std::vector<LogisticsTable::RouteId>& routeIds, Tile::Overlay overlay);
 	void clearOverlays();
-	void clearOverlay(std::vector<Tile*>& tileList);
+	void clearOverlay(const std::vector<Tile*>& tileList);
 	void updateOverlays();
 	void changePoliceOverlayDepth(int oldDepth, int newDepth);
 	void onToggleHeightmap();
@@ -261,7 +199,7 @@ private:
 	void onToggleRouteOverlay();
 	void onTogglePoliceOverlay();
 
-	void onNotificationClicked(const NotificationArea::Notification&);
+	void onNotificationClicked(const Notification&);
 
 	void onSaveGame();
 	void onLoadGame();
@@ -280,19 +218,14 @@ private:
 
 private:
 	MainReportsUiState& mMainReportsState;
-	TileMap* mTileMap{nullptr};
+	ColonySimulation mColonySimulation;
+	TileMap* mTileMap{nullptr}; /**< Non-owning, the TileMap belongs to mColonySimulation. */
 	std::unique_ptr<MapView> mMapView;
-	CrimeRateUpdate mCrimeRateUpdate;
-	CrimeExecution mCrimeExecution;
 
 	StructureTracker mStructureTracker;
 
-	ResearchTracker mResearchTracker;
 	TechnologyCatalog mTechnologyReader;
 
-	Planet::Attributes mPlanetAttributes;
-	Difficulty mDifficulty = Difficulty::Medium;
-
 	const NAS2D::Image mUiIcons{"ui/icons.png"}; /**< User interface icons. */
 	const NAS2D::Image mBackground{"sys/bg1.png"}; /**< Background image drawn behind the tile map. */
 
@@ -300,21 +233,10 @@ private:
 
 	NAS2D::Rectangle<int> mMiniMapBoundingBox; /**< Area of the site map display. */
 
-	int mFood{0};
-
-	// POOLS
-	StorableResources mResourcesCount;
-	RobotPool mRobotPool; /**< Robots that are currently available for use. */
-	PopulationPool mPopulationPool;
-
-	RobotTileTable mRobotList; /**< List of active robots and their positions on the map. */
-
 	InsertMode mInsertMode = InsertMode::None; /**< What's being inserted into the TileMap if anything. */
 	StructureID mCurrentStructure = StructureID::SID_NONE; /**< Structure being placed. */
 	Robot::Type mCurrentRobot = Robot::Type::None; /**< Robot being placed. */
 
-	Population mPopulation;
-
 	// USER INTERFACE
 	Button mBtnTurns;
 	Button mBtnToggleHeightmap;
@@ -358,26 +280,9 @@ private:
 	ReportsUiSignal mReportsUiSignal;
 	MapChangedSignal mMapChangedSignal;
 
-	// ROUTING
-	micropather::MicroPather* mPathSolver = nullptr;
-
 	// MISCELLANEOUS
-	int mTurnCount = 0;
-
-	int mCurrentMorale = constants::DefaultStartingMorale;
-	int mPreviousMorale = constants::DefaultStartingMorale;
-
-	int mLandersColonist = 0;
-	int mLandersCargo = 0;
-
-	int mResidentialCapacity = 0;
-
-	std::vector<Tile*> mConnectednessOverlay;
-	std::vector<Tile*> mCommRangeOverlay;
-	std::vector<std::vector<Tile*>> mPoliceOverlays;
-	std::vector<Tile*> mTruckRouteOverlay;
-
 	bool mLoadingExisting = false;
+	bool mShowTurnProfile = false;
 
 	std::string mExistingToLoad; /**< Filename of the existing game to load. */
 
@@ -19,6 +19,8 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <iomanip>
+#include <sstream>
 
 extern NAS2D::Point<int> MOUSE_COORDS;
 
@@ -34,7 +36,7 @@ void MapViewState::drawSystemButton() const
 	const auto turnImageRect = NAS2D::Rectangle{128, 0, constants::ResourceIconSize, constants::ResourceIconSize};
 	renderer.drawSubImage(mUiIcons, position, turnImageRect);
 	const auto& font = fontCache.load(constants::FONT_PRIMARY, constants::FontPrimaryNormal);
-	renderer.drawText(font, std::to_string(mTurnCount), position + textOffset, NAS2D::Color::White);
+	renderer.drawText(font, std::to_string(mColonySimulation.turnCount()), position + textOffset, NAS2D::Color::White);
 
 	position = mTooltipSystemButton.rect().startPoint() + NAS2D::Vector{constants::MarginTight, constants::MarginTight};
 	bool isMouseInMenu = mTooltipSystemButton.rect().contains(MOUSE_COORDS);
@@ -42,3 +44,70 @@ void MapViewState::drawSystemButton() const
 	const auto menuImageRect = NAS2D::Rectangle{menuGearHighlightOffsetX, 32, constants::ResourceIconSize, constants::ResourceIconSize};
 	renderer.drawSubImage(mUiIcons, position, menuImageRect);
 }
+
+
+/**
+ * Debug overlay listing each turn phase with its time for the last
+ * turn and its average over the profiler's history.
+ */
+void MapViewState::drawTurnProfile() const
+{
+	const auto& history = mColonySimulation.turnProfiler().history();
+	if (history.empty()) { return; }
+
+	auto& renderer = NAS2D::Utility<NAS2D::Renderer>::get();
+	const auto& font = fontCache.load(constants::FONT_PRIMARY, constants::FontPrimaryNormal);
+
+	const auto& lastTurn = history.back();
+	const auto averageOf = [&history](const std::string& phaseName)
+	{
+		double sum = 0.0;
+		for (const auto& turnRecord : history)
+		{
+			for (const auto& phase : turnRecord.phases)
+			{
+				if (phase.name == phaseName) { sum += phase.milliseconds; }
+			}
+		}
+		return sum / static_cast<double>(history.size());
+	};
+
+	const auto formatMilliseconds = [](double milliseconds)
+	{
+		std::ostringstream stream;
+		stream << std::fixed << std::setprecision(2) << milliseconds << " ms";
+		return stream.str();
+	};
+
+	constexpr int nameColumnWidth = 150;
+	constexpr int valueColumnWidth = 70;
+	const int lineHeight = font.height() + constants::MarginTight;
+	const auto lineCount = static_cast<int>(lastTurn.phases.size()) + 2;
+
+	const auto area = NAS2D::Rectangle{constants::Margin, constants::ResourceIconSize + constants::Margin * 2, nameColumnWidth + valueColumnWidth * 2 + constants::Margin * 2, lineCount * lineHeight + constants::Margin * 2};
+	renderer.drawBoxFilled(area, NAS2D::Color{0, 0, 0, 180});
+	renderer.drawBox(area, NAS2D::Color{56, 56, 56});
+
+	auto position = area.startPoint() + NAS2D::Vector{constants::Margin, constants::Margin};
+	const auto drawRow = [&](const std::string& name, const std::string& last, const std::string& average, NAS2D::Color color)
+	{
+		renderer.drawText(font, name, position, color);
+		renderer.drawText(font, last, position + NAS2D::Vector{nameColumnWidth, 0}, color);
+		renderer.drawText(font, average, position + NAS2D::Vector{nameColumnWidth + valueColumnWidth, 0}, color);
+		position.y += lineHeight;
+	};
+
+	drawRow("Turn " + std::to_string(lastTurn.turn), "Last", "Avg (" + std::to_string(history.size()) + ")", NAS2D::Color::White);
+	for (const auto& phase : lastTurn.phases)
+	{
+		drawRow(phase.name, formatMilliseconds(phase.milliseconds), formatMilliseconds(averageOf(phase.name)), NAS2D::Color{200, 200, 200});
+	}
+
+	double averageTotal = 0.0;
+	for (const auto& turnRecord : history)
+	{
+		averageTotal += turnRecord.total();
+	}
+	averageTotal /= static_cast<double>(history.size());
+	drawRow("Total", formatMilliseconds(lastTurn.total()), formatMilliseconds(averageTotal), NAS2D::Color::Yellow);
+}
@@ -14,6 +14,7 @@
 #include "../StructureManager.h"
 #include "../DirectionOffset.h"
 #include "../RobotPool.h"
+#include "../Map/CoverageGrid.h"
 #include "../Map/TileMap.h"
 #include "../Things/Structures/RobotCommand.h"
 #include "../Things/Structures/Warehouse.h"
@@ -245,7 +246,7 @@ bool selfSustained(StructureID id)
 /** 
  * Indicates that a specified tile is out of communications range (out of range of a CC or Comm Tower).
  */
-bool inCommRange(NAS2D::Point<int> position)
+bool inCommRange(const CoverageGrid& commRange, NAS2D::Point<int> position)
 {
 	auto& structureManager = NAS2D::Utility<StructureManager>::get();
 
@@ -259,29 +260,7 @@ bool inCommRange(NAS2D::Point<int> position)
 		}
 	}
 
-	const auto& command = structureManager.getStructures<CommandCenter>();
-	for (auto cc : command)
-	{
-		if (!cc->operational()) { continue; }
-
-		if (isPointInRange(position, structureManager.tileFromStructure(cc).xy(), cc->getRange()))
-		{
-			return true;
-		}
-	}
-
-	const auto& commTowers = structureManager.getStructures<CommTower>();
-	for (auto tower : commTowers)
-	{
-		if (!tower->operational()) { continue; }
-
-		if (isPointInRange(position, structureManager.tileFromStructure(tower).xy(), tower->getRange()))
-		{
-			return true;
-		}
-	}
-
-	return false;
+	return commRange.covered({position, 0});
 }
 
 
@@ -425,34 +404,7 @@ void resourceShortageMessage(const StorableResources& resources, StructureID sid
  */
 StorableResources addRefinedResources(StorableResources resourcesToAdd)
 {
-	/**
-	 * The Command Center acts as backup storage especially during the beginning of the
-	 * game before storage tanks are built. This ensure that the CC is in the storage
-	 * structure list and that it's always the first structure in the list.
-	 */
-
-	auto& command = NAS2D::Utility<StructureManager>::get().getStructures<CommandCenter>();
-	auto& storageTanks = NAS2D::Utility<StructureManager>::get().getStructures<StorageTanks>();
-
-	std::vector<Structure*> storage;
-	storage.insert(storage.end(), command.begin(), command.end());
-	storage.insert(storage.end(), storageTanks.begin(), storageTanks.end());
-
-	for (auto structure : storage)
-	{
-		if (resourcesToAdd.isEmpty()) { break; }
-
-		auto& storageTanksResources = structure->storage();
-
-		auto newResources = storageTanksResources + resourcesToAdd;
-		auto capped = newResources.cap(structure->storageCapacity() / 4);
-
-		storageTanksResources = capped;
-		resourcesToAdd = newResources - capped;
-	}
-
-	// Return remaining unstored refined resources
-	return resourcesToAdd;
+	return NAS2D::Utility<StructureManager>::get().refinedResources().add(resourcesToAdd);
 }
 
 
@@ -464,24 +416,7 @@ StorableResources addRefinedResources(StorableResources resourcesToAdd)
  */
 void removeRefinedResources(StorableResources& resourcesToRemove)
 {
-	// Command Center is backup storage, we want to pull from it last
-
-	auto& command = NAS2D::Utility<StructureManager>::get().getStructures<CommandCenter>();
-	auto& storageTanks = NAS2D::Utility<StructureManager>::get().getStructures<StorageTanks>();
-
-	std::vector<Structure*> storage;
-	storage.insert(storage.end(), storageTanks.begin(), storageTanks.end());
-	storage.insert(storage.end(), command.begin(), command.end());
-
-	for (auto structure : storage)
-	{
-		if (resourcesToRemove.isEmpty()) { break; }
-
-		auto& resourcesInStorage = structure->storage();
-		const auto toTransfer = resourcesToRemove.cap(resourcesInStorage);
-		resourcesInStorage -= toTransfer;
-		resourcesToRemove -= toTransfer;
-	}
+	NAS2D::Utility<StructureManager>::get().refinedResources().remove(resourcesToRemove);
 }
 
 
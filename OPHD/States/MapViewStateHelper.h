@@ -24,6 +24,7 @@ namespace NAS2D
 	}
 }
 
+class CoverageGrid;
 class Tile;
 class TileMap;
 class Warehouse;
@@ -44,7 +45,7 @@ bool validStructurePlacement(TileMap& tilemap, MapCoordinate position);
 bool validLanderSite(Tile& t);
 bool landingSiteSuitable(TileMap& tilemap, NAS2D::Point<int> position);
 bool structureIsLander(StructureID id);
-bool inCommRange(NAS2D::Point<int> position);
+bool inCommRange(const CoverageGrid& commRange, NAS2D::Point<int> position);
 bool isPointInRange(NAS2D::Point<int> point1, NAS2D::Point<int> point2, int distance);
 bool selfSustained(StructureID id);
 
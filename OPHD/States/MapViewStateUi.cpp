@@ -71,10 +71,10 @@ void MapViewState::initUi()
 	mFileIoDialog.hide();
 
 	mPopulationPanel.position({675, constants::ResourceIconSize + 4 + constants::MarginTight});
-	mPopulationPanel.population(&mPopulation);
+	mPopulationPanel.population(&mColonySimulation.population());
 
 	mResourceBreakdownPanel.position({0, 22});
-	mResourceBreakdownPanel.playerResources(&mResourcesCount);
+	mResourceBreakdownPanel.playerResources(&mColonySimulation.resources());
 
 	mGameOverDialog.returnToMainMenu().connect(this, &MapViewState::onGameOver);
 	mGameOverDialog.hide();
@@ -326,8 +326,8 @@ void MapViewState::populateStructureMenu()
 		mConnections.addItem({constants::AgTubeLeft, 111, ConnectorDir::CONNECTOR_LEFT});
 
 		// Special case code, not thrilled with this
-		if (mLandersColonist > 0) { mStructures.addItem({constants::ColonistLander, 2, StructureID::SID_COLONIST_LANDER}); }
-		if (mLandersCargo > 0) { mStructures.addItem({constants::CargoLander, 1, StructureID::SID_CARGO_LANDER}); }
+		if (mColonySimulation.colonistLanders() > 0) { mStructures.addItem({constants::ColonistLander, 2, StructureID::SID_COLONIST_LANDER}); }
+		if (mColonySimulation.cargoLanders() > 0) { mStructures.addItem({constants::CargoLander, 1, StructureID::SID_CARGO_LANDER}); }
 	}
 	else
 	{
@@ -381,6 +381,8 @@ void MapViewState::drawUI()
 
 	mNotificationArea.update();
 
+	if (mShowTurnProfile) { drawTurnProfile(); }
+
 	// Buttons
 	mBtnTurns.update();
 	mBtnToggleHeightmap.update();
@@ -403,7 +405,7 @@ void MapViewState::drawUI()
 }
 
 
-void MapViewState::setOverlay(std::vector<Tile*>& tileList, Tile::Overlay overlay)
+void MapViewState::setOverlay(const std::vector<Tile*>& tileList, Tile::Overlay overlay)
 {
 	for (auto tile : tileList)
 	{
@@ -412,16 +414,33 @@ void MapViewState::setOverlay(std::vector<Tile*>& tileList, Tile::Overlay overla
 }
 
 
+/**
+ * Sets the overlay on every tile along the routes that are still in the
+ * LogisticsTable.
+ */
+void MapViewState::setRouteOverlay(const std::vector<LogisticsTable::RouteId>& routeIds, Tile::Overlay overlay)
+{
+	const auto& logisticsTable = NAS2D::Utility<LogisticsTable>::get();
+	for (const auto id : routeIds)
+	{
+		if (!logisticsTable.contains(id)) { continue; }
+
+		const auto& route = logisticsTable.route(id);
+		route.forEachTile([this, &route, overlay](Route::Index index)
+		{
+			mTileMap->getTile({route.positionOf(index), 0}).overlay(overlay);
+		});
+	}
+}
+
+
 void MapViewState::clearOverlays()
 {
-	clearOverlay(mConnectednessOverlay);
-	clearOverlay(mCommRangeOverlay);
-	clearOverlay(mPoliceOverlays[mMapView->currentDepth()]);
-	clearOverlay(mTruckRouteOverlay);
+	mTileMap->clearOverlays();
 }
 
 
-void MapViewState::clearOverlay(std::vector<Tile*>& tileList)
+void MapViewState::clearOverlay(const std::vector<Tile*>& tileList)
 {
 	setOverlay(tileList, Tile::Overlay::None);
 }
@@ -429,8 +448,8 @@ void MapViewState::clearOverlay(std::vector<Tile*>& tileList)
 
 void MapViewState::changePoliceOverlayDepth(int oldDepth, int newDepth)
 {
-	clearOverlay(mPoliceOverlays[oldDepth]);
-	setOverlay(mPoliceOverlays[newDepth], Tile::Overlay::Police);
+	clearOverlay(mColonySimulation.policeOverlays()[oldDepth]);
+	setOverlay(mColonySimulation.policeOverlays()[newDepth], Tile::Overlay::Police);
 }
 
 
@@ -453,7 +472,7 @@ void MapViewState::onToggleConnectedness()
 		mBtnToggleRouteOverlay.toggle(false);
 		mBtnTogglePoliceOverlay.toggle(false);
 
-		setOverlay(mConnectednessOverlay, Tile::Overlay::Connectedness);
+		setOverlay(mColonySimulation.connectednessOverlay(), Tile::Overlay::Connectedness);
 	}
 }
 
@@ -468,7 +487,7 @@ void MapViewState::onToggleCommRangeOverlay()
 		mBtnToggleRouteOverlay.toggle(false);
 		mBtnTogglePoliceOverlay.toggle(false);
 
-		setOverlay(mCommRangeOverlay, Tile::Overlay::Communications);
+		setOverlay(mColonySimulation.commRangeOverlay(), Tile::Overlay::Communications);
 	}
 }
 
@@ -482,7 +501,7 @@ void MapViewState::onTogglePoliceOverlay()
 		mBtnToggleConnectedness.toggle(false);
 		mBtnToggleRouteOverlay.toggle(false);
 
-		setOverlay(mPoliceOverlays[mMapView->currentDepth()], Tile::Overlay::Police);
+		setOverlay(mColonySimulation.policeOverlays()[mMapView->currentDepth()], Tile::Overlay::Police);
 	}
 }
 
@@ -496,12 +515,12 @@ void MapViewState::onToggleRouteOverlay()
 		mBtnToggleCommRangeOverlay.toggle(false);
 		mBtnTogglePoliceOverlay.toggle(false);
 
-		setOverlay(mTruckRouteOverlay, Tile::Overlay::TruckingRoutes);
+		setRouteOverlay(mColonySimulation.truckRouteOverlay(), Tile::Overlay::TruckingRoutes);
 	}
 }
 
 
-void MapViewState::onNotificationClicked(const NotificationArea::Notification& notification)
+void MapViewState::onNotificationClicked(const Notification& notification)
 {
 	mNotificationWindow.notification(notification);
 	mNotificationWindow.show();
@@ -523,7 +542,7 @@ void MapViewState::onStructuresSelectionChange(const IconGrid::Item* item)
 	// Check availability
 	if (!item->available)
 	{
-		resourceShortageMessage(mResourcesCount, static_cast<StructureID>(item->meta));
+		resourceShortageMessage(mColonySimulation.resources(), static_cast<StructureID>(item->meta));
 		mStructures.clearSelection();
 		return;
 	}
@@ -573,16 +592,15 @@ void MapViewState::onDiggerSelectionDialog(Direction direction, Tile& tile)
 	if (tile.depth() > 0 && direction == Direction::Down)
 	{
 		NAS2D::Utility<StructureManager>::get().removeStructure(*tile.structure());
-		NAS2D::Utility<StructureManager>::get().disconnectAll();
 		tile.deleteThing();
-		tile.connected(false);
-		updateConnectedness();
+		mColonySimulation.updateConnectedness();
 	}
 
 	// Assumes a digger is available.
-	Robodigger& robot = mRobotPool.getDigger();
+	auto& robotPool = mColonySimulation.robotPool();
+	Robodigger& robot = robotPool.getDigger();
 	robot.startTask(static_cast<int>(tile.index()) + constants::DiggerTaskTime);
-	mRobotPool.insertRobotIntoTable(mRobotList, robot, tile);
+	mColonySimulation.deployRobot(robot, tile);
 
 	robot.direction(direction);
 
@@ -592,7 +610,7 @@ void MapViewState::onDiggerSelectionDialog(Direction direction, Tile& tile)
 		mTileMap->getTile({tile.xy() + directionOffset, tile.depth()}).excavated(true);
 	}
 
-	if (!mRobotPool.robotAvailable(Robot::Type::Digger))
+	if (!robotPool.robotAvailable(Robot::Type::Digger))
 	{
 		mRobots.removeItem(constants::Robodigger);
 		clearMode();
@@ -698,6 +716,6 @@ void MapViewState::updateStructuresAvailability()
 	for (int sid = 1; sid < StructureID::SID_COUNT; ++sid)
 	{
 		const StructureID id = static_cast<StructureID>(sid);
-		mStructures.itemAvailable(StructureName(id), StructureCatalogue::canBuild(mResourcesCount, id));
+		mStructures.itemAvailable(StructureName(id), StructureCatalogue::canBuild(mColonySimulation.resources(), id));
 	}
 }
@@ -0,0 +1,198 @@
+#include "OreLogisticsPlanner.h"
+
+#include "../Constants/Numbers.h"
+#include "../Map/Tile.h"
+#include "../Map/TileMap.h"
+#include "../Things/Structures/MineFacility.h"
+#include "../Things/Structures/OreRefining.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+
+OreLogisticsPlanner::OreLogisticsPlanner(TileMap& tileMap) :
+	mTileMap{tileMap},
+	mLimit{RouteCostGrid::toCost(constants::ShortestPathTraversalCount)}
+{
+}
+
+
+/**
+ * Brings the set of fields in line with the smelters that exist and
+ * rebuilds any online smelter's field that needs it.
+ *
+ * Smelters are kept in the order given, which decides between smelters
+ * that cost the same to reach.
+ */
+void OreLogisticsPlanner::update(std::span<OreRefining* const> smelters)
+{
+	std::vector<SmelterField> fields;
+	fields.reserve(smelters.size());
+	for (auto* smelter : smelters)
+	{
+		// A new smelter can be allocated where a removed one was, so the tile has to match too
+		const auto tile = tileIndexOf(*smelter);
+		const auto existing = std::find_if(mFields.begin(), mFields.end(), [smelter, tile](const SmelterField& smelterField) { return smelterField.smelter == smelter && smelterField.tile == tile; });
+		if (existing != mFields.end())
+		{
+			fields.push_back(std::move(*existing));
+		}
+		else
+		{
+			fields.push_back({smelter, tile, {}});
+		}
+		fields.back().online = smelter->operational();
+	}
+	mFields = std::move(fields);
+
+	const auto& routeCosts = mTileMap.routeCosts();
+
+	std::vector<SmelterField*> toRebuild;
+	for (auto& smelterField : mFields)
+	{
+		// A cheaper move than the field was sized for means it may reach past its window
+		if (routeCosts.minCost() < smelterField.field.minCost()) { smelterField.dirty = true; }
+
+		if (smelterField.online && smelterField.dirty) { toRebuild.push_back(&smelterField); }
+	}
+
+	const auto workerCount = std::min(WorkerPool::defaultWorkerCount(), toRebuild.size());
+	if (workerCount <= 1)
+	{
+		for (auto* smelterField : toRebuild) { rebuild(*smelterField, routeCosts); }
+		return;
+	}
+
+	if (!mWorkers || mWorkers->workerCount() < workerCount)
+	{
+		mWorkers = std::make_unique<WorkerPool>(workerCount);
+	}
+
+	mWorkers->forEach(toRebuild.size(), [this, &toRebuild, &routeCosts](std::size_t, std::size_t i)
+	{
+		rebuild(*toRebuild[i], routeCosts);
+	});
+}
+
+
+/**
+ * Drops a smelter's field. Called as the smelter is removed, so nothing
+ * is left pointing at it.
+ */
+void OreLogisticsPlanner::remove(const OreRefining& smelter)
+{
+	std::erase_if(mFields, [&smelter](const SmelterField& smelterField) { return smelterField.smelter == &smelter; });
+}
+
+
+/**
+ * Called when what it costs to drive over a surface tile changes.
+ */
+void OreLogisticsPlanner::invalidate(NAS2D::Point<int> position)
+{
+	const auto tile = static_cast<Index>(Route::indexOf(position, mTileMap.size().x));
+	for (auto& smelterField : mFields)
+	{
+		if (smelterField.dirty) { continue; }
+
+		const auto nearest = smelterField.field.nearestCost(tile);
+		if (nearest == RouteCostGrid::Impassable) { continue; }
+
+		if (nearest <= smelterField.horizon)
+		{
+			smelterField.dirty = true;
+		}
+		else
+		{
+			smelterField.stale = true;
+		}
+	}
+}
+
+
+/**
+ * Online smelters a mine can haul to, cheapest first.
+ */
+std::vector<OreLogisticsPlanner::Destination> OreLogisticsPlanner::destinations(const MineFacility& mine)
+{
+	const auto tile = tileIndexOf(mine);
+
+	std::vector<Destination> result;
+	for (auto& smelterField : mFields)
+	{
+		if (!smelterField.online) { continue; }
+
+		const auto cost = read(smelterField, tile);
+		if (cost != RouteCostGrid::Impassable)
+		{
+			result.push_back({smelterField.smelter, RouteCostGrid::toFloat(cost)});
+		}
+	}
+
+	std::stable_sort(result.begin(), result.end(), [](const Destination& a, const Destination& b) { return a.cost < b.cost; });
+	return result;
+}
+
+
+/**
+ * Cheapest route from a mine to a smelter, or an empty Route if the mine
+ * can't haul to it.
+ */
+Route OreLogisticsPlanner::route(const MineFacility& mine, const OreRefining& smelter)
+{
+	const auto smelterField = std::find_if(mFields.begin(), mFields.end(), [&smelter](const SmelterField& entry) { return entry.smelter == &smelter; });
+	if (smelterField == mFields.end() || !smelterField->online) { return {}; }
+
+	const auto tile = tileIndexOf(mine);
+	const auto cost = read(*smelterField, tile);
+	if (cost == RouteCostGrid::Impassable) { return {}; }
+
+	const auto& routeCosts = mTileMap.routeCosts();
+	return Route::fromTiles(smelterField->field.path(routeCosts, tile), routeCosts.size().x, RouteCostGrid::toFloat(cost));
+}
+
+
+OreLogisticsPlanner::Index OreLogisticsPlanner::tileIndexOf(const OreRefining& smelter) const
+{
+	return Route::indexOf(smelter.tile()->xy(), mTileMap.size().x);
+}
+
+
+OreLogisticsPlanner::Index OreLogisticsPlanner::tileIndexOf(const MineFacility& mine) const
+{
+	return Route::indexOf(mine.tile()->xy(), mTileMap.size().x);
+}
+
+
+/**
+ * Looks up a tile's cost in a field, first rebuilding the field if it's
+ * out of date for that tile.
+ */
+OreLogisticsPlanner::Cost OreLogisticsPlanner::read(SmelterField& smelterField, Index tile)
+{
+	if (smelterField.dirty)
+	{
+		rebuild(smelterField, mTileMap.routeCosts());
+	}
+
+	auto cost = smelterField.field.cost(tile);
+	if (smelterField.stale && cost > smelterField.horizon)
+	{
+		rebuild(smelterField, mTileMap.routeCosts());
+		cost = smelterField.field.cost(tile);
+	}
+
+	// A tile out of reach could be brought in reach by a change anywhere in the field
+	smelterField.horizon = std::max(smelterField.horizon, std::min(cost, mLimit));
+	return cost;
+}
+
+
+void OreLogisticsPlanner::rebuild(SmelterField& smelterField, const RouteCostGrid& routeCosts) const
+{
+	smelterField.field.build(routeCosts, smelterField.tile, mLimit);
+	smelterField.horizon = 0;
+	smelterField.dirty = false;
+	smelterField.stale = false;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Route.h"
+
+#include "../WorkerPool.h"
+#include "../Map/DistanceField.h"
+
+#include <NAS2D/Math/Point.h>
+
+#include <memory>
+#include <span>
+#include <vector>
+
+
+class TileMap;
+class MineFacility;
+class OreRefining;
+
+
+/**
+ * Decides where mines send their ore.
+ *
+ * Keeps a DistanceField for every smelter, so the cost of hauling from
+ * any mine to any smelter is a single lookup. Fields only reach as far as
+ * trucks can haul anything, constants::ShortestPathTraversalCount.
+ *
+ * Fields are kept while their smelter is offline, so a smelter coming back
+ * online costs nothing unless the map changed near it in the meantime.
+ * Each field also tracks the most expensive cost it has handed out. A
+ * tile change further out than that can't affect anything read from it,
+ * so the field is only rebuilt if something beyond that is asked for
+ * later.
+ *
+ * Fields that need rebuilding are rebuilt side by side on a WorkerPool.
+ * The pool is started the first time more than one field needs it and
+ * never has more workers than there were fields to rebuild.
+ */
+class OreLogisticsPlanner
+{
+public:
+	using Index = DistanceField::Index;
+	using Cost = DistanceField::Cost;
+
+	struct Destination
+	{
+		OreRefining* smelter;
+		float cost;
+	};
+
+public:
+	explicit OreLogisticsPlanner(TileMap& tileMap);
+
+	OreLogisticsPlanner(const OreLogisticsPlanner&) = delete;
+	OreLogisticsPlanner& operator=(const OreLogisticsPlanner&) = delete;
+
+	void update(std::span<OreRefining* const> smelters);
+	void remove(const OreRefining& smelter);
+	void invalidate(NAS2D::Point<int> position);
+
+	std::vector<Destination> destinations(const MineFacility& mine);
+	Route route(const MineFacility& mine, const OreRefining& smelter);
+
+private:
+	struct SmelterField
+	{
+		OreRefining* smelter;
+		Index tile;
+		DistanceField field;
+		Cost horizon{0}; /**< Most expensive cost read since the field was built. */
+		bool online{false};
+		bool dirty{true};
+		bool stale{false}; /**< A tile beyond the horizon changed. */
+	};
+
+	Index tileIndexOf(const OreRefining& smelter) const;
+	Index tileIndexOf(const MineFacility& mine) const;
+
+	Cost read(SmelterField& smelterField, Index tile);
+	void rebuild(SmelterField& smelterField, const RouteCostGrid& routeCosts) const;
+
+	TileMap& mTileMap;
+	Cost mLimit;
+
+	std::vector<SmelterField> mFields;
+	std::unique_ptr<WorkerPool> mWorkers;
+};
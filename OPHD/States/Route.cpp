@@ -0,0 +1,66 @@
+#include "Route.h"
+
+#include <stdexcept>
+
+
+Route::Index Route::indexOf(NAS2D::Point<int> position, int mapWidth)
+{
+	return static_cast<Index>(position.y) * static_cast<Index>(mapWidth) + static_cast<Index>(position.x);
+}
+
+
+/**
+ * Builds a route from every tile along it, keeping only its corners.
+ *
+ * \param	tiles	Surface indices of each tile from start to end. Each
+ *			tile must be next to the one before it.
+ */
+Route Route::fromTiles(std::span<const Index> tiles, int mapWidth, float cost)
+{
+	Route route;
+	route.mapWidth = static_cast<Index>(mapWidth);
+	route.length = static_cast<std::uint32_t>(tiles.size());
+	route.cost = cost;
+
+	if (tiles.empty()) { return route; }
+
+	route.corners.push_back(tiles.front());
+	for (std::size_t i = 1; i + 1 < tiles.size(); ++i)
+	{
+		// A tile is a corner when the step into it differs from the step out of it
+		const auto stepIn = static_cast<std::int64_t>(tiles[i]) - static_cast<std::int64_t>(tiles[i - 1]);
+		const auto stepOut = static_cast<std::int64_t>(tiles[i + 1]) - static_cast<std::int64_t>(tiles[i]);
+		if (stepIn != stepOut)
+		{
+			route.corners.push_back(tiles[i]);
+		}
+	}
+	if (tiles.size() > 1)
+	{
+		route.corners.push_back(tiles.back());
+	}
+
+	return route;
+}
+
+
+NAS2D::Point<int> Route::positionOf(Index index) const
+{
+	if (mapWidth == 0)
+	{
+		throw std::runtime_error("Route::positionOf(): Route has no map width");
+	}
+	return {static_cast<int>(index % mapWidth), static_cast<int>(index / mapWidth)};
+}
+
+
+/**
+ * Expands the route back into every tile along it.
+ */
+std::vector<Route::Index> Route::tiles() const
+{
+	std::vector<Index> result;
+	result.reserve(length);
+	forEachTile([&result](Index index) { result.push_back(index); });
+	return result;
+}
@@ -1,13 +1,65 @@
 #pragma once
 
-#include <map>
+#include <NAS2D/Math/Point.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <vector>
 
+
+/**
+ * Truck route across the surface.
+ *
+ * Tiles are 32-bit surface indices (y * map width + x). Only the first
+ * and last tiles and the tiles where the route turns are stored; the route
+ * runs in a straight line from each of these corners to the next, so its
+ * size depends on how often it turns rather than how long it is.
+ */
 struct Route
 {
-	bool empty() const { return path.empty(); }
+	using Index = std::uint32_t;
+
+	static Index indexOf(NAS2D::Point<int> position, int mapWidth);
+	static Route fromTiles(std::span<const Index> tiles, int mapWidth, float cost);
+
+	bool empty() const { return corners.empty(); }
+
+	Index start() const { return corners.front(); }
+	Index end() const { return corners.back(); }
+
+	NAS2D::Point<int> positionOf(Index index) const;
+
+	std::vector<Index> tiles() const;
+
+	/**
+	 * Calls function with the index of every tile along the route, from
+	 * start to end.
+	 */
+	template <typename Function>
+	void forEachTile(Function function) const
+	{
+		if (corners.empty()) { return; }
+
+		function(corners.front());
+		for (std::size_t i = 1; i < corners.size(); ++i)
+		{
+			const auto from = corners[i - 1];
+			const auto to = corners[i];
+			const auto distance = to > from ? to - from : from - to;
+			const auto step = distance < mapWidth ? Index{1} : mapWidth;
+
+			for (auto index = from; index != to;)
+			{
+				index = to > from ? index + step : index - step;
+				function(index);
+			}
+		}
+	}
 
-	std::vector<void*> path;
+	std::vector<Index> corners;
+	Index mapWidth = 0;
+	std::uint32_t length = 0; /**< Number of tiles along the route. */
 	float cost = 0.0f;
 };
 
@@ -7,18 +7,89 @@
 #include "Map/Tile.h"
 #include "Things/Robots/Robot.h"
 
-#include "States/MapViewStateHelper.h" // <-- For removeRefinedResources()
-
 #include <NAS2D/ParserHelper.h>
 #include <NAS2D/StringUtils.h>
 #include <NAS2D/ContainerUtils.h>
 
 #include <algorithm>
+#include <array>
 #include <sstream>
+#include <tuple>
+#include <type_traits>
 
 
 namespace
 {
+	struct StructureUpdateStep
+	{
+		Structure::StructureClass structureClass;
+		bool updateEnergyProductionAfter;
+	};
+
+
+	/**
+	 * Order in which structure classes are updated each turn.
+	 *
+	 * High priority structures are updated first. Energy production is totalled
+	 * right after the producers have been updated so lower priority structures
+	 * see the energy that is actually available. Tubes need no update.
+	 */
+	constexpr std::array StructureUpdateSchedule
+	{
+		StructureUpdateStep{Structure::StructureClass::Lander, false}, // No resource needs
+		StructureUpdateStep{Structure::StructureClass::Command, false}, // Self sufficient
+		StructureUpdateStep{Structure::StructureClass::EnergyProduction, true}, // Nothing can work without energy
+
+		// Basic resource production
+		StructureUpdateStep{Structure::StructureClass::Mine, false}, // Can't operate without resources.
+		StructureUpdateStep{Structure::StructureClass::Smelter, false},
+
+		StructureUpdateStep{Structure::StructureClass::LifeSupport, false}, // Air, water food must come before others
+		StructureUpdateStep{Structure::StructureClass::FoodProduction, false},
+
+		StructureUpdateStep{Structure::StructureClass::MedicalCenter, false}, // No medical facilities, people die
+		StructureUpdateStep{Structure::StructureClass::Nursery, false},
+
+		StructureUpdateStep{Structure::StructureClass::Factory, false}, // Production
+		StructureUpdateStep{Structure::StructureClass::Maintenance, false},
+
+		StructureUpdateStep{Structure::StructureClass::Storage, false}, // Everything else.
+		StructureUpdateStep{Structure::StructureClass::Park, false},
+		StructureUpdateStep{Structure::StructureClass::SurfacePolice, false},
+		StructureUpdateStep{Structure::StructureClass::UndergroundPolice, false},
+		StructureUpdateStep{Structure::StructureClass::RecreationCenter, false},
+		StructureUpdateStep{Structure::StructureClass::Recycling, false},
+		StructureUpdateStep{Structure::StructureClass::Residence, false},
+		StructureUpdateStep{Structure::StructureClass::RobotCommand, false},
+		StructureUpdateStep{Structure::StructureClass::Warehouse, false},
+		StructureUpdateStep{Structure::StructureClass::Laboratory, false},
+		StructureUpdateStep{Structure::StructureClass::Commercial, false},
+		StructureUpdateStep{Structure::StructureClass::University, false},
+		StructureUpdateStep{Structure::StructureClass::Communication, false},
+		StructureUpdateStep{Structure::StructureClass::Road, false},
+
+		StructureUpdateStep{Structure::StructureClass::Undefined, false},
+	};
+
+	/**
+	 * True if every structure class but Tube is updated exactly once.
+	 */
+	constexpr bool schedulesEveryClassOnce()
+	{
+		for (std::size_t index = 0; index < StructureClassCount; ++index)
+		{
+			const auto structureClass = static_cast<Structure::StructureClass>(index);
+			const auto expected = structureClass == Structure::StructureClass::Tube ? 0 : 1;
+			const auto scheduled = std::count_if(StructureUpdateSchedule.begin(), StructureUpdateSchedule.end(), [structureClass](const StructureUpdateStep& step) { return step.structureClass == structureClass; });
+			if (scheduled != expected) { return false; }
+		}
+		return true;
+	}
+
+	static_assert(StructureUpdateSchedule.size() == StructureClassCount - 1, "Every structure class except Tube must be scheduled for update");
+	static_assert(schedulesEveryClassOnce(), "Every structure class except Tube must be scheduled exactly once");
+
+
 	/**
 	 * Fills population requirements fields in a Structure.
 	 */
@@ -137,7 +208,7 @@ namespace
 
 bool StructureManager::CHAPAvailable()
 {
-	for (auto chap : mStructureLists[Structure::StructureClass::LifeSupport])
+	for (auto chap : structureList(Structure::StructureClass::LifeSupport))
 	{
 		if (chap->operational()) { return true; }
 	}
@@ -146,50 +217,21 @@ bool StructureManager::CHAPAvailable()
 }
 
 
-void StructureManager::update(const StorableResources& resources, PopulationPool& population)
+void StructureManager::update(PopulationPool& population)
 {
 	mAgingStructures.clear();
 	mNewlyBuiltStructures.clear();
 	mStructuresWithCrime.clear();
 
-	// Called separately so that 1) high priority structures can be updated first and
-	// 2) so that resource handling code (like energy) can be handled between update
-	// calls to lower priority structures.
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Lander]); // No resource needs
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Command]); // Self sufficient
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::EnergyProduction]); // Nothing can work without energy
-
-	updateEnergyProduction();
-
-	// Basic resource production
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Mine]); // Can't operate without resources.
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Smelter]);
-
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::LifeSupport]); // Air, water food must come before others
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::FoodProduction]);
-
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::MedicalCenter]); // No medical facilities, people die
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Nursery]);
-
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Factory]); // Production
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Maintenance]);
-
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Storage]); // Everything else.
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Park]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::SurfacePolice]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::UndergroundPolice]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::RecreationCenter]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Recycling]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Residence]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::RobotCommand]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Warehouse]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Laboratory]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Commercial]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::University]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Communication]);
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Road]);
-
-	updateStructures(resources, population, mStructureLists[Structure::StructureClass::Undefined]);
+	for (const auto& step : StructureUpdateSchedule)
+	{
+		updateStructures(population, classList(step.structureClass));
+
+		if (step.updateEnergyProductionAfter)
+		{
+			updateEnergyProduction();
+		}
+	}
 
 	assignColonistsToResidences(population);
 }
@@ -200,7 +242,7 @@ void StructureManager::updateEnergyProduction()
 	mTotalEnergyOutput = 0;
 	mTotalEnergyUsed = 0;
 
-	for (auto structure : mStructureLists[Structure::StructureClass::EnergyProduction])
+	for (auto structure : structureList(Structure::StructureClass::EnergyProduction))
 	{
 		auto powerStructure = static_cast<PowerStructure*>(structure);
 		if (powerStructure->operational())
@@ -217,25 +259,14 @@ void StructureManager::updateEnergyProduction()
  */
 void StructureManager::updateEnergyConsumed()
 {
-	mTotalEnergyUsed = 0;
-
-	for (auto& classListPair : mStructureLists)
-	{
-		for (auto structure : classListPair.second)
-		{
-			if (structure->operational())
-			{
-				mTotalEnergyUsed += structure->energyRequirement();
-			}
-		}
-	}
+	mTotalEnergyUsed = mStatistics.operationalEnergyRequirement();
 }
 
 
 void StructureManager::assignColonistsToResidences(PopulationPool& population)
 {
 	int populationCount = population.size();
-	for (auto structure : mStructureLists[Structure::StructureClass::Residence])
+	for (auto structure : structureList(Structure::StructureClass::Residence))
 	{
 		Residence* residence = static_cast<Residence*>(structure);
 		if (residence->operational())
@@ -247,7 +278,7 @@ void StructureManager::assignColonistsToResidences(PopulationPool& population)
 }
 
 
-void StructureManager::updateStructures(const StorableResources& resources, PopulationPool& population, StructureList& structures)
+void StructureManager::updateStructures(PopulationPool& population, StructureList& structures)
 {
 	Structure* structure = nullptr;
 	for (std::size_t i = 0; i < structures.size(); ++i)
@@ -317,7 +348,7 @@ void StructureManager::updateStructures(const StorableResources& resources, Popu
 		}
 
 		// Check that enough resources are available for input.
-		if (!structure->isIdle() && !(resources >= structure->resourcesIn()))
+		if (!structure->isIdle() && !(mRefinedResources.stored() >= structure->resourcesIn()))
 		{
 			structure->disable(DisabledReason::RefinedResources);
 			continue;
@@ -330,7 +361,7 @@ void StructureManager::updateStructures(const StorableResources& resources, Popu
 			population.usePopulation(populationRequired);
 
 			auto consumed = structure->resourcesIn();
-			removeRefinedResources(consumed);
+			mRefinedResources.remove(consumed);
 
 			mTotalEnergyUsed += structure->energyRequirement();
 
@@ -345,7 +376,7 @@ void StructureManager::updateStructures(const StorableResources& resources, Popu
  */
 void StructureManager::addStructure(Structure& structure, Tile& tile)
 {
-	if (mStructureTileTable.find(&structure) != mStructureTileTable.end())
+	if (structure.tile())
 	{
 		throw std::runtime_error("StructureManager::addStructure(): Attempting to add a Structure that is already managed!");
 	}
@@ -356,10 +387,19 @@ void StructureManager::addStructure(Structure& structure, Tile& tile)
 		tile.removeThing();
 	}
 
+	structure.tile(&tile);
+#ifdef OPHD_CHECK_STRUCTURE_TILES
 	mStructureTileTable[&structure] = &tile;
+#endif
 
-	mStructureLists[structure.structureClass()].push_back(&structure);
+	classList(structure.structureClass()).push_back(&structure);
+	addToTypeLists(structure);
+	mStatistics.add(structure);
+	mRefinedResources.addStorage(structure);
+	structure.statistics(&mStatistics);
 	tile.pushThing(&structure);
+
+	mStructureAddedSignal(tile);
 }
 
 
@@ -371,59 +411,93 @@ void StructureManager::addStructure(Structure& structure, Tile& tile)
  */
 void StructureManager::removeStructure(Structure& structure)
 {
-	StructureList& structures = mStructureLists[structure.structureClass()];
+	StructureList& structures = classList(structure.structureClass());
 
 	const auto it = std::find(structures.begin(), structures.end(), &structure);
 	const auto isFoundStructureTable = it != structures.end();
 	if (isFoundStructureTable)
 	{
 		structures.erase(it);
+		removeFromTypeLists(structure);
 	}
 
-	const auto tileTableIt = mStructureTileTable.find(&structure);
-	const auto isFoundTileTable = tileTableIt != mStructureTileTable.end();
-	if (isFoundTileTable)
+	auto* tile = structure.tile();
+	if (!isFoundStructureTable || !tile)
 	{
-		tileTableIt->second->deleteThing();
-		mStructureTileTable.erase(tileTableIt);
+		throw std::runtime_error("StructureManager::removeStructure(): Attempting to remove a Structure that is not managed by the StructureManager.");
 	}
 
-	if (!isFoundStructureTable || !isFoundTileTable)
+#ifdef OPHD_CHECK_STRUCTURE_TILES
+	mStructureTileTable.erase(&structure);
+#endif
+
+	mStructureRemovedSignal(*tile);
+
+	structure.statistics(nullptr);
+	mStatistics.remove(structure);
+	mRefinedResources.removeStorage(structure);
+	tile->deleteThing();
+}
+
+
+/**
+ * Adds a structure to the list of every type it can be viewed as through
+ * getStructures(). Type checks only happen here so lookups are free of RTTI.
+ */
+void StructureManager::addToTypeLists(Structure& structure)
+{
+	const auto addIfMatching = [&structure](auto& typeList)
 	{
-		throw std::runtime_error("StructureManager::removeStructure(): Attempting to remove a Structure that is not managed by the StructureManager.");
-	}
+		using StructureType = std::remove_pointer_t<typename std::remove_reference_t<decltype(typeList)>::value_type>;
+		if (structureTypeToClass<StructureType>() != structure.structureClass()) { return; }
+
+		if (auto derivedStructure = dynamic_cast<StructureType*>(&structure))
+		{
+			typeList.push_back(derivedStructure);
+		}
+	};
+
+	std::apply([&addIfMatching](auto&... typeLists) { (addIfMatching(typeLists), ...); }, mStructureTypeLists);
 }
 
 
-const StructureList& StructureManager::structureList(Structure::StructureClass structureClass)
+void StructureManager::removeFromTypeLists(Structure& structure)
 {
-	return mStructureLists[structureClass];
+	const auto removeIfPresent = [&structure](auto& typeList)
+	{
+		const auto it = std::find_if(typeList.begin(), typeList.end(), [&structure](const Structure* listed) { return listed == &structure; });
+		if (it != typeList.end())
+		{
+			typeList.erase(it);
+		}
+	};
+
+	std::apply([&removeIfPresent](auto&... typeLists) { (removeIfPresent(typeLists), ...); }, mStructureTypeLists);
 }
 
 
-StructureList StructureManager::allStructures()
+const StructureList& StructureManager::structureList(Structure::StructureClass structureClass) const
 {
-	StructureList structuresOut;
+	return mStructureLists[static_cast<std::size_t>(structureClass)];
+}
 
-	for (auto& classListPair : mStructureLists)
-	{
-		auto& structures = classListPair.second;
-		std::copy(structures.begin(), structures.end(), std::back_inserter(structuresOut));
-	}
 
-	return structuresOut;
+StructureList& StructureManager::classList(Structure::StructureClass structureClass)
+{
+	return mStructureLists[static_cast<std::size_t>(structureClass)];
 }
 
 
-/**
- * Resets the 'connected' flag on all structures in the primary structure list.
- */
-void StructureManager::disconnectAll()
+StructureList StructureManager::allStructures()
 {
-	for (auto& pair : mStructureTileTable)
+	StructureList structuresOut;
+
+	for (const auto& structures : mStructureLists)
 	{
-		pair.second->connected(false);
+		std::copy(structures.begin(), structures.end(), std::back_inserter(structuresOut));
 	}
+
+	return structuresOut;
 }
 
 
@@ -432,80 +506,71 @@ void StructureManager::disconnectAll()
  */
 int StructureManager::count() const
 {
-	int count = 0;
-	for (auto& pair : mStructureLists)
-	{
-		count += static_cast<int>(pair.second.size());
-	}
-
-	return count;
+	return mStatistics.count();
 }
 
 
-int StructureManager::getCountInState(Structure::StructureClass structureClass, StructureState state)
+int StructureManager::getCountInState(Structure::StructureClass structureClass, StructureState state) const
 {
-	int count = 0;
-	for (const auto* structure : structureList(structureClass))
-	{
-		if (structure->state() == state)
-		{
-			++count;
-		}
-	}
-	return count;
+	return mStatistics.count(structureClass, state);
 }
 
 
 /**
  * Gets a count of the number of disabled buildings.
  */
-int StructureManager::disabled()
+int StructureManager::disabled() const
 {
-	int count = 0;
-	for (auto& pair : mStructureLists)
-	{
-		count += getCountInState(pair.first, StructureState::Disabled);
-	}
-
-	return count;
+	return mStatistics.count(StructureState::Disabled);
 }
 
 
 /**
  * Gets a count of the number of destroyed buildings.
  */
-int StructureManager::destroyed()
+int StructureManager::destroyed() const
 {
-	int count = 0;
-	for (auto& pair : mStructureLists)
-	{
-		count += getCountInState(pair.first, StructureState::Destroyed);
-	}
-
-	return count;
+	return mStatistics.count(StructureState::Destroyed);
 }
 
 
 void StructureManager::dropAllStructures()
 {
-	for (auto& pair : mStructureTileTable)
+	for (auto& structures : mStructureLists)
 	{
-		pair.second->deleteThing();
+		for (auto structure : structures)
+		{
+			structure->tile()->deleteThing();
+		}
+		structures.clear();
 	}
 
+#ifdef OPHD_CHECK_STRUCTURE_TILES
 	mStructureTileTable.clear();
-	mStructureLists.clear();
+#endif
+	std::apply([](auto&... typeLists) { (typeLists.clear(), ...); }, mStructureTypeLists);
+	mStatistics.clear();
+	mRefinedResources.clear();
 }
 
 
 Tile& StructureManager::tileFromStructure(Structure* structure)
 {
-	auto it = mStructureTileTable.find(structure);
-	if (it == mStructureTileTable.end())
+	auto* tile = structure->tile();
+	if (!tile)
 	{
 		throw std::runtime_error("Could not find tile for structure");
 	}
-	return *it->second;
+
+#ifdef OPHD_CHECK_STRUCTURE_TILES
+	const auto it = mStructureTileTable.find(structure);
+	if (it == mStructureTileTable.end() || it->second != tile)
+	{
+		throw std::runtime_error("StructureManager::tileFromStructure(): Structure tile does not match the structure tile table");
+	}
+#endif
+
+	return *tile;
 }
 
 
@@ -513,9 +578,12 @@ NAS2D::Xml::XmlElement* StructureManager::serialize(std::map<const Robot*, int>
 {
 	auto* structures = new NAS2D::Xml::XmlElement("structures");
 
-	for (auto& [structure, tile] : mStructureTileTable)
+	for (const auto& structureList : mStructureLists)
 	{
-		structures->linkEndChild(serializeStructure(*structure, *tile, robotToIdMap));
+		for (auto structure : structureList)
+		{
+			structures->linkEndChild(serializeStructure(*structure, *structure->tile(), robotToIdMap));
+		}
 	}
 
 	return structures;
@@ -524,5 +592,5 @@ NAS2D::Xml::XmlElement* StructureManager::serialize(std::map<const Robot*, int>
 
 bool StructureManager::structureConnected(Structure* structure)
 {
-	return mStructureTileTable[structure]->connected();
+	return structure->tile()->connected();
 }
@@ -1,9 +1,19 @@
 #pragma once
 
+#include "RefinedResourceLedger.h"
+#include "StructureStatistics.h"
+
 #include "Things/Structures/Structure.h"
 #include "Things/Structures/Structures.h"
 
+#include <NAS2D/Signal/Signal.h>
+
+#include <array>
+#include <cstddef>
 #include <map>
+#include <span>
+#include <tuple>
+#include <vector>
 
 
 namespace NAS2D
@@ -76,47 +86,51 @@ constexpr Structure::StructureClass structureTypeToClass() {
  */
 class StructureManager
 {
+public:
+	using StructureTileSignal = NAS2D::Signal<Tile&>;
+
 public:
 	void addStructure(Structure& structure, Tile& tile);
 	void removeStructure(Structure& structure);
 
+	/**
+	 * Gets all structures of a type, including types derived from it
+	 * that share its StructureClass.
+	 *
+	 * \note	The returned view refers to storage owned by the StructureManager
+	 *			and is invalidated when a structure is added or removed.
+	 */
 	template <typename StructureType>
-	const std::vector<StructureType*> getStructures()
+	const std::span<StructureType* const> getStructures() const
 	{
-		// Get list of structures with same function
-		const auto& sameClassStructures = structureList(structureTypeToClass<StructureType>());
-
-		std::vector<StructureType*> output;
-		// Filter for instances of the exact type parameter
-		for (auto structure : sameClassStructures)
-		{
-			StructureType* derivedStructure = dynamic_cast<StructureType*>(structure);
-			if (derivedStructure)
-			{
-				output.push_back(derivedStructure);
-			}
-		}
-		return output;
+		return std::get<std::vector<StructureType*>>(mStructureTypeLists);
 	}
 
-	const StructureList& structureList(Structure::StructureClass structureClass);
+	const StructureList& structureList(Structure::StructureClass structureClass) const;
 	StructureList allStructures();
 
 	Tile& tileFromStructure(Structure* structure);
 
-	void disconnectAll();
 	void dropAllStructures();
 
+	StructureTileSignal::Source& structureAdded() { return mStructureAddedSignal; }
+	StructureTileSignal::Source& structureRemoved() { return mStructureRemovedSignal; }
+
 	int count() const;
 
-	int getCountInState(Structure::StructureClass structureClass, StructureState state);
+	const StructureStatistics& statistics() const { return mStatistics; }
+
+	RefinedResourceLedger& refinedResources() { return mRefinedResources; }
+	const RefinedResourceLedger& refinedResources() const { return mRefinedResources; }
+
+	int getCountInState(Structure::StructureClass structureClass, StructureState state) const;
 
 	const StructureList& agingStructures() const { return mAgingStructures; }
 	const StructureList& newlyBuiltStructures() const { return mNewlyBuiltStructures; }
 	const StructureList& structuresWithCrime() const { return mStructuresWithCrime; }
 
-	int disabled();
-	int destroyed();
+	int disabled() const;
+	int destroyed() const;
 
 	bool CHAPAvailable();
 
@@ -128,25 +142,87 @@ public:
 
 	void assignColonistsToResidences(PopulationPool&);
 
-	void update(const StorableResources&, PopulationPool&);
+	void update(PopulationPool&);
 
 	NAS2D::Xml::XmlElement* serialize(std::map<const Robot*, int> robotToIdMap);
 
 private:
 	using StructureTileTable = std::map<Structure*, Tile*>;
-	using StructureClassTable = std::map<Structure::StructureClass, StructureList>;
-
-	void updateStructures(const StorableResources&, PopulationPool&, StructureList&);
+	using StructureClassTable = std::array<StructureList, StructureClassCount>;
+
+	/** One list per concrete and intermediate structure type served by getStructures(). */
+	using StructureTypeLists = std::tuple<
+		std::vector<Agridome*>,
+		std::vector<AirShaft*>,
+		std::vector<CargoLander*>,
+		std::vector<CHAP*>,
+		std::vector<ColonistLander*>,
+		std::vector<CommandCenter*>,
+		std::vector<Commercial*>,
+		std::vector<CommTower*>,
+		std::vector<Factory*>,
+		std::vector<FoodProduction*>,
+		std::vector<FusionReactor*>,
+		std::vector<HotLaboratory*>,
+		std::vector<Laboratory*>,
+		std::vector<MaintenanceFacility*>,
+		std::vector<MedicalCenter*>,
+		std::vector<MineFacility*>,
+		std::vector<MineShaft*>,
+		std::vector<Nursery*>,
+		std::vector<OreRefining*>,
+		std::vector<Park*>,
+		std::vector<PowerStructure*>,
+		std::vector<RecreationCenter*>,
+		std::vector<Recycling*>,
+		std::vector<RedLightDistrict*>,
+		std::vector<Residence*>,
+		std::vector<Road*>,
+		std::vector<RobotCommand*>,
+		std::vector<SeedFactory*>,
+		std::vector<SeedLander*>,
+		std::vector<SeedPower*>,
+		std::vector<SeedSmelter*>,
+		std::vector<Smelter*>,
+		std::vector<SolarPanelArray*>,
+		std::vector<SolarPlant*>,
+		std::vector<StorageTanks*>,
+		std::vector<SurfaceFactory*>,
+		std::vector<SurfacePolice*>,
+		std::vector<Tube*>,
+		std::vector<UndergroundFactory*>,
+		std::vector<UndergroundPolice*>,
+		std::vector<University*>,
+		std::vector<Warehouse*>
+	>;
+
+	void addToTypeLists(Structure& structure);
+	void removeFromTypeLists(Structure& structure);
+
+	void updateStructures(PopulationPool&, StructureList&);
+
+	StructureList& classList(Structure::StructureClass structureClass);
 
 	bool structureConnected(Structure* structure);
 
-	StructureTileTable mStructureTileTable; /**< List mapping Structures to a particular tile. */
-	StructureClassTable mStructureLists; /**< Map containing all of the structure list types available. */
+	// Structures know their own tile. Define OPHD_CHECK_STRUCTURE_TILES to also
+	// track them here and verify every tileFromStructure() lookup against it.
+#ifdef OPHD_CHECK_STRUCTURE_TILES
+	StructureTileTable mStructureTileTable;
+#endif
+
+	StructureClassTable mStructureLists; /**< Structure lists indexed by StructureClass. */
+	StructureTypeLists mStructureTypeLists; /**< Per type lists backing getStructures(). */
+	StructureStatistics mStatistics;
+	RefinedResourceLedger mRefinedResources;
 
 	StructureList mAgingStructures;
 	StructureList mNewlyBuiltStructures;
 	StructureList mStructuresWithCrime;
 
+	StructureTileSignal mStructureAddedSignal; /**< Emitted after a structure is placed on its tile. */
+	StructureTileSignal mStructureRemovedSignal; /**< Emitted before a structure is removed from its tile. */
+
 	int mTotalEnergyOutput = 0; /**< Total energy output of all energy producers in the structure list. */
 	int mTotalEnergyUsed = 0;
 };
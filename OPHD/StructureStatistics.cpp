@@ -0,0 +1,44 @@
+#include "StructureStatistics.h"
+
+
+void StructureStatistics::add(const Structure& structure)
+{
+	mClassCounts[index(structure.structureClass())]++;
+	mTotal++;
+	adjust(structure, structure.state(), 1);
+}
+
+
+void StructureStatistics::remove(const Structure& structure)
+{
+	adjust(structure, structure.state(), -1);
+	mClassCounts[index(structure.structureClass())]--;
+	mTotal--;
+}
+
+
+void StructureStatistics::stateChanged(const Structure& structure, StructureState oldState, StructureState newState)
+{
+	if (oldState == newState) { return; }
+
+	adjust(structure, oldState, -1);
+	adjust(structure, newState, 1);
+}
+
+
+void StructureStatistics::clear()
+{
+	*this = StructureStatistics{};
+}
+
+
+void StructureStatistics::adjust(const Structure& structure, StructureState state, int delta)
+{
+	mCounts[index(structure.structureClass())][index(state)] += delta;
+	mStateCounts[index(state)] += delta;
+
+	if (state == StructureState::Operational)
+	{
+		mOperationalEnergyRequirement += structure.energyRequirement() * delta;
+	}
+}
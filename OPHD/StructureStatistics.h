@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Things/Structures/Structure.h"
+
+#include <array>
+#include <cstddef>
+
+
+/** Number of Structure::StructureClass values. Warehouse must remain the last enumerator. */
+constexpr std::size_t StructureClassCount = static_cast<std::size_t>(Structure::StructureClass::Warehouse) + 1;
+
+/** Number of StructureState values. Destroyed must remain the last enumerator. */
+constexpr std::size_t StructureStateCount = static_cast<std::size_t>(StructureState::Destroyed) + 1;
+
+
+/**
+ * Running counts of managed structures by class and state.
+ *
+ * Kept up to date by the StructureManager as structures are added and
+ * removed and by each Structure as its state changes, so none of the
+ * queries here need to look at the structures themselves.
+ */
+class StructureStatistics
+{
+public:
+	int count() const { return mTotal; }
+	int count(StructureState state) const { return mStateCounts[index(state)]; }
+	int count(Structure::StructureClass structureClass) const { return mClassCounts[index(structureClass)]; }
+	int count(Structure::StructureClass structureClass, StructureState state) const { return mCounts[index(structureClass)][index(state)]; }
+
+	/** Sum of the energy requirement of every operational structure. */
+	int operationalEnergyRequirement() const { return mOperationalEnergyRequirement; }
+
+private:
+	friend class Structure;
+	friend class StructureManager;
+
+	void add(const Structure& structure);
+	void remove(const Structure& structure);
+	void stateChanged(const Structure& structure, StructureState oldState, StructureState newState);
+	void clear();
+
+	void adjust(const Structure& structure, StructureState state, int delta);
+
+	static constexpr std::size_t index(Structure::StructureClass structureClass) { return static_cast<std::size_t>(structureClass); }
+	static constexpr std::size_t index(StructureState state) { return static_cast<std::size_t>(state); }
+
+	std::array<std::array<int, StructureStateCount>, StructureClassCount> mCounts{};
+	std::array<int, StructureClassCount> mClassCounts{};
+	std::array<int, StructureStateCount> mStateCounts{};
+	int mTotal{0};
+	int mOperationalEnergyRequirement{0};
+};
@@ -41,6 +41,7 @@ public:
 
 protected:
 	friend class MapViewState;
+	friend class ColonySimulation;
 
 	StorableResources maxTransferAmounts();
 
@@ -2,6 +2,7 @@
 
 #include "Structure.h"
 
+#include "../../Constants/Numbers.h"
 #include "../../Constants/Strings.h"
 
 
@@ -19,4 +20,32 @@ public:
 		requiresCHAP(false);
 		selfSustained(true);
 	}
+
+	/**
+	 * Checks whether the road has crossed one of the thresholds that change
+	 * what a truck pays to drive over it since the last time this was called.
+	 */
+	bool routeConditionChanged()
+	{
+		const auto condition = routeCondition();
+		const bool changed = condition != mRouteCondition;
+		mRouteCondition = condition;
+		return changed;
+	}
+
+private:
+	enum class RouteCondition
+	{
+		Good,
+		Decayed,
+		Impaired
+	};
+
+	RouteCondition routeCondition() const
+	{
+		if (!operational()) { return RouteCondition::Impaired; }
+		return integrity() < constants::RoadIntegrityChange ? RouteCondition::Decayed : RouteCondition::Good;
+	}
+
+	RouteCondition mRouteCondition{RouteCondition::Good};
 };
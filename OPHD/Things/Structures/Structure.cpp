@@ -1,6 +1,7 @@
 #include "Structure.h"
 
 #include "../../RandomNumberGenerator.h"
+#include "../../StructureStatistics.h"
 #include "../../Constants/Strings.h"
 #include <algorithm>
 
@@ -120,6 +121,13 @@ Structure::Structure(const std::string& name, const std::string& spritePath, con
 }
 
 
+void Structure::state(StructureState newState)
+{
+	if (mStatistics) { mStatistics->stateChanged(*this, mStructureState, newState); }
+	mStructureState = newState;
+}
+
+
 /**
  * Sets a Disabled state for the Structure.
  */
@@ -327,7 +335,7 @@ void Structure::forced_state_change(StructureState structureState, DisabledReaso
 	else if (structureState == StructureState::Idle) { idle(idleReason); }
 	else if (structureState == StructureState::Disabled) { disable(disabledReason); }
 	else if (structureState == StructureState::Destroyed) { destroy(); }
-	else if (structureState == StructureState::UnderConstruction) { mStructureState = StructureState::UnderConstruction; } // Kludge
+	else if (structureState == StructureState::UnderConstruction) { state(StructureState::UnderConstruction); } // Kludge
 }
 
 
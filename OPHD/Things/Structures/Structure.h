@@ -10,6 +10,10 @@
 #include <NAS2D/Dictionary.h>
 
 
+class Tile;
+class StructureStatistics;
+
+
 /**
  * State of an individual Structure.
  */
@@ -107,6 +111,12 @@ public:
 
 	// ATTRIBUTES
 	StructureClass structureClass() const { return mStructureClass; }
+
+	/**
+	 * Tile the Structure occupies, or nullptr if it is not managed by
+	 * the StructureManager.
+	 */
+	Tile* tile() const { return mTile; }
 	const std::string& stateDescription() const;
 	static const std::string& stateDescription(StructureState state);
 	const std::string& classDescription() const;
@@ -164,6 +174,10 @@ public:
 
 protected:
 	friend class StructureCatalogue;
+	friend class StructureManager;
+
+	void tile(Tile* newTile) { mTile = newTile; }
+	void statistics(StructureStatistics* newStatistics) { mStatistics = newStatistics; }
 
 	void turnsToBuild(int newTurnsToBuild) { mTurnsToBuild = newTurnsToBuild; }
 	void maxAge(int newMaxAge) { mMaxAge = newMaxAge; }
@@ -178,7 +192,7 @@ protected:
 
 	virtual void disabledStateSet() {}
 
-	void state(StructureState newState) { mStructureState = newState; }
+	void state(StructureState newState);
 
 	void requiresCHAP(bool value) { mRequiresCHAP = value; }
 	void selfSustained(bool value) { mSelfSustained = value; }
@@ -216,6 +230,9 @@ private:
 
 	StructureID mStructureId{StructureID::SID_NONE};
 
+	Tile* mTile{nullptr}; /**< Set by the StructureManager while the Structure is managed. */
+	StructureStatistics* mStatistics{nullptr}; /**< Notified of state changes while the Structure is managed. */
+
 	StructureState mStructureState{StructureState::UnderConstruction};
 	StructureClass mStructureClass{StructureClass::Undefined};
 	ConnectorDir mConnectorDirection{ConnectorDir::CONNECTOR_INTERSECTION};
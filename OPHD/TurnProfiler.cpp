@@ -0,0 +1,125 @@
+#include "TurnProfiler.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+
+double TurnProfiler::TurnRecord::total() const
+{
+	double sum = 0.0;
+	for (const auto& phase : phases)
+	{
+		sum += phase.milliseconds;
+	}
+	return sum;
+}
+
+
+TurnProfiler::Scope::Scope(TurnProfiler& profiler, std::string phaseName) :
+	mProfiler{profiler},
+	mPhaseName{std::move(phaseName)},
+	mStart{Clock::now()}
+{
+}
+
+
+TurnProfiler::Scope::~Scope()
+{
+	const auto elapsed = std::chrono::duration<double, std::milli>{Clock::now() - mStart};
+	mProfiler.record(mPhaseName, elapsed.count());
+}
+
+
+TurnProfiler::TurnProfiler(std::size_t historySize) :
+	mHistorySize{historySize}
+{
+	if (mHistorySize == 0)
+	{
+		throw std::runtime_error("TurnProfiler history size must be greater than zero");
+	}
+}
+
+
+void TurnProfiler::beginTurn(int turn)
+{
+	mHistory.push_back({turn, {}});
+	while (mHistory.size() > mHistorySize)
+	{
+		mHistory.pop_front();
+	}
+}
+
+
+/**
+ * Adds a phase time to the most recent turn. Time recorded before
+ * the first turn is discarded.
+ *
+ * A phase recorded more than once in the same turn is accumulated.
+ */
+void TurnProfiler::record(const std::string& phaseName, double milliseconds)
+{
+	if (mHistory.empty()) { return; }
+
+	auto& phases = mHistory.back().phases;
+	auto it = std::find_if(phases.begin(), phases.end(), [&phaseName](const PhaseTime& phase) { return phase.name == phaseName; });
+	if (it != phases.end())
+	{
+		it->milliseconds += milliseconds;
+		return;
+	}
+
+	phases.push_back({phaseName, milliseconds});
+}
+
+
+void TurnProfiler::clear()
+{
+	mHistory.clear();
+}
+
+
+/**
+ * Formats the history as CSV with one row per turn and one column per
+ * phase. Columns appear in the order phases were first recorded.
+ */
+std::string TurnProfiler::toCsv() const
+{
+	std::vector<std::string> columns;
+	for (const auto& turnRecord : mHistory)
+	{
+		for (const auto& phase : turnRecord.phases)
+		{
+			if (std::find(columns.begin(), columns.end(), phase.name) == columns.end())
+			{
+				columns.push_back(phase.name);
+			}
+		}
+	}
+
+	std::ostringstream csv;
+	csv << "turn";
+	for (const auto& column : columns)
+	{
+		csv << "," << column;
+	}
+	csv << ",total\n";
+
+	for (const auto& turnRecord : mHistory)
+	{
+		csv << turnRecord.turn;
+		for (const auto& column : columns)
+		{
+			csv << ",";
+			const auto it = std::find_if(turnRecord.phases.begin(), turnRecord.phases.end(), [&column](const PhaseTime& phase) { return phase.name == column; });
+			if (it != turnRecord.phases.end())
+			{
+				csv << it->milliseconds;
+			}
+		}
+		csv << "," << turnRecord.total() << "\n";
+	}
+
+	return csv.str();
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+
+/**
+ * Records how long each phase of a turn takes.
+ *
+ * Each call to beginTurn() starts a new record. Phases are timed with a
+ * Scope, which adds its elapsed time to the most recent record, so work
+ * done after ColonySimulation::nextTurn() returns, like the UI refresh in
+ * MapViewState, is attributed to the turn it follows.
+ *
+ * Phases are told apart by name, so every Scope should use its own.
+ *
+ * Only the last historySize() turns are kept.
+ */
+class TurnProfiler
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct PhaseTime
+	{
+		std::string name;
+		double milliseconds;
+	};
+
+	struct TurnRecord
+	{
+		int turn;
+		std::vector<PhaseTime> phases;
+
+		double total() const;
+	};
+
+	/**
+	 * Times the enclosing block and records it as a phase when it goes out of scope.
+	 */
+	class Scope
+	{
+	public:
+		Scope(TurnProfiler& profiler, std::string phaseName);
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		TurnProfiler& mProfiler;
+		std::string mPhaseName;
+		Clock::time_point mStart;
+	};
+
+public:
+	static constexpr std::size_t DefaultHistorySize = 100;
+
+	TurnProfiler() = default;
+	explicit TurnProfiler(std::size_t historySize);
+
+	void beginTurn(int turn);
+
+	void record(const std::string& phaseName, double milliseconds);
+
+	std::size_t historySize() const { return mHistorySize; }
+	const std::deque<TurnRecord>& history() const { return mHistory; }
+
+	void clear();
+
+	std::string toCsv() const;
+
+private:
+	std::size_t mHistorySize{DefaultHistorySize};
+	std::deque<TurnRecord> mHistory;
+};
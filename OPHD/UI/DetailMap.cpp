@@ -9,7 +9,6 @@
 #include <NAS2D/Renderer/Color.h>
 #include <NAS2D/Renderer/Renderer.h>
 #include <NAS2D/Utility.h>
-#include <NAS2D/Math/PointInRectangleRange.h>
 
 #include <map>
 #include <cmath>
@@ -98,41 +97,56 @@ Tile& DetailMap::mouseTile()
 }
 
 
+/**
+ * Updates the sprites of the Things in view.
+ */
 void DetailMap::update()
 {
-	for (const auto tilePosition : PointInRectangleRange{mMapView.viewArea()})
+	for (const auto row : mTileMap.tiles(mMapView.viewArea(), mMapView.currentDepth()))
 	{
-		auto& tile = mTileMap.getTile({tilePosition, mMapView.currentDepth()});
-
-		if (tile.thing())
+		for (auto& tile : row)
 		{
-			tile.thing()->sprite().update();
+			if (auto* thing = tile.thing())
+			{
+				thing->sprite().update();
+			}
 		}
 	}
 }
 
 
+/**
+ * Draws the tiles in view, row by row, culling unexcavated tiles from the
+ * excavated plane before anything else about them is read.
+ */
 void DetailMap::draw() const
 {
 	auto& renderer = Utility<Renderer>::get();
 
 	int tsetOffset = mMapView.currentDepth() > 0 ? TileDrawSize.y : 0;
 
-	for (const auto tilePosition : PointInRectangleRange{mMapView.viewArea()})
+	const auto viewArea = mMapView.viewArea();
+	const auto visibleTiles = mTileMap.tiles(viewArea, mMapView.currentDepth());
+	for (int y = viewArea.y; y < viewArea.endPoint().y; ++y)
 	{
-		auto& tile = mTileMap.getTile({tilePosition, mMapView.currentDepth()});
-
-		if (tile.excavated())
+		const auto row = visibleTiles.row(y);
+		for (int x = viewArea.x; x < viewArea.endPoint().x; ++x)
 		{
-			const auto offset = tilePosition - mMapView.viewArea().startPoint();
+			auto& tile = row[static_cast<std::size_t>(x - viewArea.x)];
+			if (!tile.excavated()) { continue; }
+
+			const auto tilePosition = NAS2D::Point{x, y};
+			const auto offset = tilePosition - viewArea.startPoint();
 			const auto position = mOriginPixelPosition - TileDrawOffset + NAS2D::Vector{(offset.x - offset.y) * TileSize.x / 2, (offset.x + offset.y) * TileSize.y / 2};
 			const auto subImageRect = NAS2D::Rectangle{static_cast<int>(tile.index()) * TileDrawSize.x, tsetOffset, TileDrawSize.x, TileDrawSize.y};
 			const bool isTileHighlighted = tilePosition == mMouseTilePosition;
 
 			renderer.drawSubImage(mTileset, position, subImageRect, overlayColor(tile.overlay(), isTileHighlighted));
 
+			auto* thing = tile.thing();
+
 			// Draw a beacon on an unoccupied tile with a mine
-			if (tile.mine() != nullptr && !tile.thing())
+			if (tile.mine() != nullptr && !thing)
 			{
 				uint8_t glow = static_cast<uint8_t>(120 + std::sin(throbTimer.tick() / ThrobSpeed) * 57);
 				renderer.drawImage(mMineBeacon, position + NAS2D::Vector{0, -64});
@@ -140,9 +154,9 @@ void DetailMap::draw() const
 			}
 
 			// Tell an occupying thing to update itself.
-			if (tile.thing())
+			if (thing)
 			{
-				tile.thing()->sprite().draw(position);
+				thing->sprite().draw(position);
 			}
 		}
 	}
@@ -4,7 +4,7 @@
 #include "../Map/TileMap.h"
 #include "../Map/MapView.h"
 #include "../Things/Robots/Robot.h"
-#include "../States/Route.h"
+#include "../States/LogisticsTable.h"
 #include "../StructureManager.h"
 
 #include <NAS2D/Utility.h>
@@ -13,6 +13,7 @@
 #include <NAS2D/Renderer/Color.h>
 #include <NAS2D/Renderer/Renderer.h>
 
+#include <algorithm>
 #include <map>
 
 
@@ -29,7 +30,7 @@ MiniMap::MiniMap(MapView& mapView, TileMap* tileMap, const std::map<Robot*, Tile
 	mRobotList{robotList},
 	mIsHeightMapVisible{false},
 	mBackgroundSatellite{mapName + MapDisplayExtension},
-	mBackgroundHeightMap{mapName + MapTerrainExtension},
+	mBackgroundHeightMap{imageCache.load(mapName + MapTerrainExtension)},
 	mUiIcons{imageCache.load("ui/icons.png")}
 {}
 
@@ -55,13 +56,13 @@ void MiniMap::draw() const
 	const auto miniMapBoxFloat = mRect.to<float>();
 	renderer.clipRect(miniMapBoxFloat);
 
-	renderer.drawImage((mIsHeightMapVisible ? mBackgroundHeightMap : mBackgroundSatellite), miniMapBoxFloat.startPoint());
+	const auto mapArea = NAS2D::Rectangle<int>::Create(mRect.startPoint(), toMiniMap(NAS2D::Point{0, 0} + mTileMap->size()));
+	renderer.drawImageStretched((mIsHeightMapVisible ? mBackgroundHeightMap : mBackgroundSatellite), mapArea);
 
-	const auto miniMapOffset = mRect.startPoint() - NAS2D::Point{0, 0};
 	const auto ccPosition = ccLocation();
 	if (ccPosition != CcNotPlaced)
 	{
-		const auto ccOffsetPosition = ccPosition + miniMapOffset;
+		const auto ccOffsetPosition = toMiniMap(ccPosition);
 		const auto ccCommRangeImageRect = NAS2D::Rectangle{166, 226, 30, 30};
 		renderer.drawSubImage(mUiIcons, ccOffsetPosition - ccCommRangeImageRect.size() / 2, ccCommRangeImageRect);
 		renderer.drawBoxFilled(NAS2D::Rectangle<int>::Create(ccOffsetPosition - NAS2D::Vector{1, 1}, NAS2D::Vector{3, 3}), NAS2D::Color::White);
@@ -74,7 +75,7 @@ void MiniMap::draw() const
 		{
 			const auto commTowerPosition = structureManager.tileFromStructure(commTower).xy();
 			const auto commTowerRangeImageRect = NAS2D::Rectangle{146, 236, 20, 20};
-			renderer.drawSubImage(mUiIcons, commTowerPosition + miniMapOffset - commTowerRangeImageRect.size() / 2, commTowerRangeImageRect);
+			renderer.drawSubImage(mUiIcons, toMiniMap(commTowerPosition) - commTowerRangeImageRect.size() / 2, commTowerRangeImageRect);
 		}
 	}
 
@@ -89,30 +90,30 @@ void MiniMap::draw() const
 		else { mineBeaconStatusOffsetX = 16; }
 
 		const auto mineImageRect = NAS2D::Rectangle{mineBeaconStatusOffsetX, 0, 7, 7};
-		renderer.drawSubImage(mUiIcons, minePosition + miniMapOffset - NAS2D::Vector{2, 2}, mineImageRect);
+		renderer.drawSubImage(mUiIcons, toMiniMap(minePosition) - NAS2D::Vector{2, 2}, mineImageRect);
 	}
 
 	// Temporary debug aid, will be slow with high numbers of mines
 	// especially with routes of longer lengths.
-	auto& routeTable = NAS2D::Utility<std::map<class MineFacility*, Route>>::get();
-	for (auto route : routeTable)
+	const auto& logisticsTable = NAS2D::Utility<LogisticsTable>::get();
+	logisticsTable.forEachRoute([this, &renderer](LogisticsTable::RouteId, const Route& route)
 	{
-		for (auto tile : route.second.path)
+		route.forEachTile([this, &renderer, &route](Route::Index index)
 		{
-			const auto tilePosition = static_cast<Tile*>(tile)->xy();
-			renderer.drawPoint(tilePosition + miniMapOffset, NAS2D::Color::Magenta);
-		}
-	}
+			renderer.drawPoint(toMiniMap(route.positionOf(index)), NAS2D::Color::Magenta);
+		});
+	});
 
 	for (auto robotEntry : mRobotList)
 	{
 		const auto robotPosition = robotEntry.second->xy();
-		renderer.drawPoint(robotPosition + miniMapOffset, NAS2D::Color::Cyan);
+		renderer.drawPoint(toMiniMap(robotPosition), NAS2D::Color::Cyan);
 	}
 
 	const auto& viewArea = mMapView.viewArea();
-	renderer.drawBox(viewArea.translate(miniMapOffset + NAS2D::Vector{1, 1}), NAS2D::Color{0, 0, 0, 180});
-	renderer.drawBox(viewArea.translate(miniMapOffset), NAS2D::Color::White);
+	const auto viewBox = NAS2D::Rectangle<int>::Create(toMiniMap(viewArea.startPoint()), toMiniMap(viewArea.endPoint()));
+	renderer.drawBox(viewBox.translate({1, 1}), NAS2D::Color{0, 0, 0, 180});
+	renderer.drawBox(viewBox, NAS2D::Color::White);
 
 	renderer.clipRectClear();
 }
@@ -159,6 +160,28 @@ void MiniMap::onMouseMove(int x, int y, int /*rX*/, int /*rY*/)
 
 void MiniMap::onSetView(NAS2D::Point<int> mousePixel)
 {
-	const auto position = NAS2D::Point{0, 0} + (mousePixel - mRect.startPoint());
-	mMapView.centerOn(position);
+	mMapView.centerOn(toMap(mousePixel));
+}
+
+
+/**
+ * Minimap pixels per map tile. Maps too big for the minimap are shrunk to
+ * fit, keeping their proportions. Smaller maps are drawn a pixel per tile.
+ */
+float MiniMap::mapScale() const
+{
+	const auto mapSize = mTileMap->size().to<float>();
+	return std::min({1.0f, static_cast<float>(mRect.width) / mapSize.x, static_cast<float>(mRect.height) / mapSize.y});
+}
+
+
+NAS2D::Point<int> MiniMap::toMiniMap(NAS2D::Point<int> mapPosition) const
+{
+	return mRect.startPoint() + ((mapPosition - NAS2D::Point{0, 0}).to<float>() * mapScale()).to<int>();
+}
+
+
+NAS2D::Point<int> MiniMap::toMap(NAS2D::Point<int> miniMapPixel) const
+{
+	return NAS2D::Point{0, 0} + ((miniMapPixel - mRect.startPoint()).to<float>() / mapScale()).to<int>();
 }
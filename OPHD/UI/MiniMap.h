@@ -2,6 +2,7 @@
 
 #include "Core/Control.h"
 
+#include <NAS2D/Math/Point.h>
 #include <NAS2D/Math/Rectangle.h>
 #include <NAS2D/Resource/Image.h>
 #include <NAS2D/EventHandler.h>
@@ -36,12 +37,16 @@ protected:
 	void onSetView(NAS2D::Point<int> mousePixel);
 
 private:
+	float mapScale() const;
+	NAS2D::Point<int> toMiniMap(NAS2D::Point<int> mapPosition) const;
+	NAS2D::Point<int> toMap(NAS2D::Point<int> miniMapPixel) const;
+
 	MapView& mMapView;
 	TileMap* mTileMap;
 	const std::map<Robot*, Tile*>& mRobotList;
 	bool mIsHeightMapVisible;
 	NAS2D::Image mBackgroundSatellite;
-	NAS2D::Image mBackgroundHeightMap;
+	const NAS2D::Image& mBackgroundHeightMap; /**< Shared with TileMap through the image cache. */
 	const NAS2D::Image& mUiIcons;
 	bool mLeftButtonDown{false};
 };
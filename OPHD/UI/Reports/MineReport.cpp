@@ -10,7 +10,7 @@
 #include "../../StructureManager.h"
 #include "../../ProductionCost.h"
 
-#include "../../States/Route.h"
+#include "../../States/LogisticsTable.h"
 
 #include "../../Things/Structures/MineFacility.h"
 
@@ -429,8 +429,7 @@ void MineReport::drawTruckMangementPane(const NAS2D::Point<int>& origin)
 	drawLabelAndValueRightJustify(origin + NAS2D::Vector{0, 30}, labelWidth, "Trucks Assigned to Facility", std::to_string(miningFacility->assignedTrucks()), textColor);
 	drawLabelAndValueRightJustify(origin + NAS2D::Vector{0, 45}, labelWidth, "Trucks Available in Storage", std::to_string(mAvailableTrucks), textColor);
 
-	auto& routeTable = NAS2D::Utility<std::map<class MineFacility*, Route>>::get();
-	bool routeAvailable = routeTable.find(miningFacility) != routeTable.end();
+	bool routeAvailable = NAS2D::Utility<LogisticsTable>::get().routeFor(*miningFacility) != nullptr;
 
 	if (miningFacility->operational() || miningFacility->isIdle())
 	{
@@ -452,10 +451,9 @@ void MineReport::drawTruckHaulInfo(const NAS2D::Point<int>& origin)
 {
 	auto& r = Utility<Renderer>::get();
 	const auto textColor = NAS2D::Color{0, 185, 0};
-	auto& routeTable = NAS2D::Utility<std::map<class MineFacility*, Route>>::get();
 	const auto mFacility = static_cast<MineFacility*>(mSelectedFacility);
 
-	auto& route = routeTable[mFacility];
+	const auto& route = *NAS2D::Utility<LogisticsTable>::get().routeFor(*mFacility);
 	drawLabelAndValueRightJustify(origin,
 		btnAddTruck.positionX() - origin.x - 10,
 		"Route Cost",
@@ -211,14 +211,8 @@ int ResourceInfoBar::totalStorage(Structure::StructureClass structureClass, int
 		storageCapacity += constants::BaseStorageCapacity;
 	}
 
-	const auto& structures = NAS2D::Utility<StructureManager>::get().structureList(structureClass);
-	for (auto structure : structures)
-	{
-		if (structure->operational() || structure->isIdle())
-		{
-			storageCapacity += capacity;
-		}
-	}
+	const auto& statistics = NAS2D::Utility<StructureManager>::get().statistics();
+	storageCapacity += (statistics.count(structureClass, StructureState::Operational) + statistics.count(structureClass, StructureState::Idle)) * capacity;
 
 	return storageCapacity;
 }
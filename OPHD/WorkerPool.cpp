@@ -0,0 +1,128 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+
+/**
+ * One worker per hardware thread, or one if that can't be determined.
+ */
+std::size_t WorkerPool::defaultWorkerCount()
+{
+	return std::max(std::size_t{1}, static_cast<std::size_t>(std::thread::hardware_concurrency()));
+}
+
+
+/**
+ * \param	workerCount	Number of workers including the thread that calls
+ *			forEach(). Values below one are treated as one.
+ */
+WorkerPool::WorkerPool(std::size_t workerCount) :
+	mErrors(std::max(std::size_t{1}, workerCount))
+{
+	for (std::size_t worker = 1; worker < workerCount; ++worker)
+	{
+		mThreads.emplace_back(&WorkerPool::workerLoop, this, worker);
+	}
+}
+
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard lock{mMutex};
+		mStopping = true;
+	}
+	mWake.notify_all();
+
+	for (auto& thread : mThreads)
+	{
+		thread.join();
+	}
+}
+
+
+/**
+ * Calls work once for each item in [0, itemCount) and waits for all of
+ * them to finish. Items are handed out in order but may finish in any
+ * order.
+ *
+ * If any item throws, remaining items are skipped and the exception from
+ * the lowest numbered worker is rethrown once every worker has stopped.
+ */
+void WorkerPool::forEach(std::size_t itemCount, const Work& work)
+{
+	if (itemCount == 0) { return; }
+
+	if (mThreads.empty() || itemCount == 1)
+	{
+		for (std::size_t item = 0; item < itemCount; ++item)
+		{
+			work(0, item);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard lock{mMutex};
+		mWork = &work;
+		mItemCount = itemCount;
+		mNextItem = 0;
+		mBusyThreads = mThreads.size();
+		std::fill(mErrors.begin(), mErrors.end(), nullptr);
+		++mBatch;
+	}
+	mWake.notify_all();
+
+	runItems(0);
+
+	{
+		std::unique_lock lock{mMutex};
+		mDone.wait(lock, [this] { return mBusyThreads == 0; });
+		mWork = nullptr;
+	}
+
+	for (const auto& error : mErrors)
+	{
+		if (error) { std::rethrow_exception(error); }
+	}
+}
+
+
+void WorkerPool::workerLoop(std::size_t worker)
+{
+	std::uint64_t lastBatch = 0;
+	while (true)
+	{
+		{
+			std::unique_lock lock{mMutex};
+			mWake.wait(lock, [this, lastBatch] { return mStopping || mBatch != lastBatch; });
+			if (mStopping) { return; }
+			lastBatch = mBatch;
+		}
+
+		runItems(worker);
+
+		{
+			std::lock_guard lock{mMutex};
+			--mBusyThreads;
+		}
+		mDone.notify_one();
+	}
+}
+
+
+void WorkerPool::runItems(std::size_t worker)
+{
+	try
+	{
+		for (auto item = mNextItem++; item < mItemCount; item = mNextItem++)
+		{
+			(*mWork)(worker, item);
+		}
+	}
+	catch (...)
+	{
+		mErrors[worker] = std::current_exception();
+		mNextItem = mItemCount;
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Fixed set of threads that share out the items of a batch of work.
+ *
+ * forEach() blocks until every item is done and runs items on the calling
+ * thread as well, so a pool with one worker never starts a thread. Work
+ * is told which worker is running it so it can keep per worker state
+ * without locking.
+ *
+ * forEach() must not be called from inside a work item or from more than
+ * one thread at a time.
+ */
+class WorkerPool
+{
+public:
+	using Work = std::function<void(std::size_t worker, std::size_t item)>;
+
+	static std::size_t defaultWorkerCount();
+
+public:
+	explicit WorkerPool(std::size_t workerCount = defaultWorkerCount());
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	std::size_t workerCount() const { return mThreads.size() + 1; }
+
+	void forEach(std::size_t itemCount, const Work& work);
+
+private:
+	void workerLoop(std::size_t worker);
+	void runItems(std::size_t worker);
+
+	std::vector<std::thread> mThreads;
+
+	std::mutex mMutex;
+	std::condition_variable mWake;
+	std::condition_variable mDone;
+	std::uint64_t mBatch{0};
+	std::size_t mBusyThreads{0};
+	bool mStopping{false};
+
+	const Work* mWork{nullptr};
+	std::size_t mItemCount{0};
+	std::atomic<std::size_t> mNextItem{0};
+	std::vector<std::exception_ptr> mErrors;
+};
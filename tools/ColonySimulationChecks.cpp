@@ -0,0 +1,221 @@
+// ==================================================================================
+// = Regression checks for colony rules that only show up once structures are placed
+// = and robots finish their tasks. Each check starts a new colony on the first
+// = shipped planet, plays out one situation through ColonySimulation the way the
+// = game's UI would and reports whether the colony ended up in the expected state.
+// = Structures load their sprites, so it needs the data files but no Renderer.
+// ==================================================================================
+
+#include "../OPHD/Common.h"
+#include "../OPHD/StructureManager.h"
+#include "../OPHD/Map/RouteCostGrid.h"
+#include "../OPHD/Map/TileMap.h"
+#include "../OPHD/States/ColonySimulation.h"
+#include "../OPHD/States/MapViewStateHelper.h"
+#include "../OPHD/States/Planet.h"
+#include "../OPHD/Things/Robots/Robodigger.h"
+#include "../OPHD/Things/Robots/Robodozer.h"
+#include "../OPHD/Things/Structures/CommandCenter.h"
+#include "../OPHD/Things/Structures/CommTower.h"
+
+#include <NAS2D/Utility.h>
+#include <NAS2D/Filesystem.h>
+#include <NAS2D/Math/Point.h>
+#include <NAS2D/Math/Vector.h>
+
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	constexpr std::uint64_t RandomSeed = 1;
+
+	/** Offset from a seed lander's center to the tile east of its east tube. */
+	const NAS2D::Vector<int> DigSiteOffset{2, 0};
+
+
+	struct Check
+	{
+		std::string name;
+		bool (*run)(const Planet::Attributes&);
+	};
+
+
+	/**
+	 * Finds a spot for a seed lander with no mines under it or on the dig site
+	 * next to it, keeping the dig site within the margin placeRobodigger allows.
+	 */
+	NAS2D::Point<int> findLanderSite(TileMap& tileMap)
+	{
+		const auto size = tileMap.size();
+		for (int y = 4; y < size.y - 4; ++y)
+		{
+			for (int x = 4; x < size.x - 4 - DigSiteOffset.x; ++x)
+			{
+				bool clear = true;
+				for (int offsetY = -1; offsetY <= 1 && clear; ++offsetY)
+				{
+					for (int offsetX = -1; offsetX <= DigSiteOffset.x && clear; ++offsetX)
+					{
+						clear = !tileMap.getTile({{x + offsetX, y + offsetY}, 0}).hasMine();
+					}
+				}
+				if (clear) { return {x, y}; }
+			}
+		}
+		throw std::runtime_error("No room on the map for a seed lander.");
+	}
+
+
+	/**
+	 * Deploys a seed lander with its Command Center already built, so
+	 * the tubes around it are connected.
+	 */
+	NAS2D::Point<int> deployColony(ColonySimulation& colonySimulation)
+	{
+		const auto landerPosition = findLanderSite(*colonySimulation.tileMap());
+		colonySimulation.onDeploySeedLander(landerPosition);
+
+		for (auto commandCenter : NAS2D::Utility<StructureManager>::get().getStructures<CommandCenter>())
+		{
+			commandCenter->forced_state_change(StructureState::Operational, DisabledReason::None, IdleReason::None);
+		}
+		colonySimulation.updateConnectedness();
+
+		return landerPosition;
+	}
+
+
+	/**
+	 * A digger sent down next to a connected tube leaves an AirShaft on
+	 * both levels, and the lower one is connected through the upper one.
+	 */
+	bool digDownConnectsAirShaft(const Planet::Attributes& attributes)
+	{
+		ColonySimulation colonySimulation{attributes, Difficulty::Medium, RandomSeed};
+		auto& tileMap = *colonySimulation.tileMap();
+		const auto landerPosition = deployColony(colonySimulation);
+
+		auto& surfaceTile = tileMap.getTile({landerPosition + DigSiteOffset, 0});
+		auto& robotPool = colonySimulation.robotPool();
+		auto& digger = robotPool.getDigger();
+		digger.startTask(1);
+		colonySimulation.deployRobot(digger, surfaceTile);
+		digger.direction(Direction::Down);
+		digger.update();
+
+		const auto& lowerTile = tileMap.getTile({surfaceTile.xy(), 1});
+		const auto passed = surfaceTile.connected() && lowerTile.thingIsStructure() && lowerTile.connected();
+
+		NAS2D::Utility<StructureManager>::get().dropAllStructures();
+		return passed;
+	}
+
+
+	/**
+	 * Bulldozing a Comm Tower takes its range out of communications
+	 * coverage straight away, the way the dozer removes it.
+	 */
+	bool bulldozedCommTowerStopsCovering(const Planet::Attributes& attributes)
+	{
+		ColonySimulation colonySimulation{attributes, Difficulty::Medium, RandomSeed};
+		auto& tileMap = *colonySimulation.tileMap();
+		const auto size = tileMap.size();
+		auto& towerTile = tileMap.getTile({{size.x / 2, size.y / 2}, 0});
+
+		auto& structureManager = NAS2D::Utility<StructureManager>::get();
+		auto& commTower = *new CommTower();
+		structureManager.addStructure(commTower, towerTile);
+		commTower.forced_state_change(StructureState::Operational, DisabledReason::None, IdleReason::None);
+		colonySimulation.updateCommRangeOverlay();
+
+		const auto position = towerTile.xy();
+		const auto coveredWhileStanding = inCommRange(colonySimulation.commRangeCoverage(), position);
+
+		structureManager.removeStructure(commTower);
+		towerTile.deleteThing();
+		const auto coveredWhenBulldozed = inCommRange(colonySimulation.commRangeCoverage(), position);
+
+		structureManager.dropAllStructures();
+		return coveredWhileStanding && !coveredWhenBulldozed;
+	}
+
+
+	/**
+	 * A dozer blocks trucks while it works a tile and the tile can be
+	 * driven over again once the dozer is done with it.
+	 */
+	bool dozedTileIsPassableAgain(const Planet::Attributes& attributes)
+	{
+		ColonySimulation colonySimulation{attributes, Difficulty::Medium, RandomSeed};
+		auto& tileMap = *colonySimulation.tileMap();
+		const auto landerPosition = deployColony(colonySimulation);
+
+		auto& tile = tileMap.getTile({landerPosition + DigSiteOffset, 0});
+		auto& dozer = colonySimulation.robotPool().getDozer();
+		dozer.startTask(1);
+		colonySimulation.deployRobot(dozer, tile);
+		dozer.tileIndex(static_cast<std::size_t>(tile.index()));
+		colonySimulation.dozeTile(tile);
+
+		const auto index = tileMap.routeCosts().indexOf(tile.xy());
+		const auto blockedWhileDozing = tileMap.routeCosts().passCost(index) == RouteCostGrid::Impassable;
+
+		colonySimulation.nextTurn();
+		const auto passableWhenDone = dozer.idle() && tileMap.routeCosts().passCost(index) != RouteCostGrid::Impassable;
+
+		NAS2D::Utility<StructureManager>::get().dropAllStructures();
+		return blockedWhileDozing && passableWhenDone;
+	}
+
+
+	const std::vector<Check> Checks =
+	{
+		{"dig down connects the lower AirShaft", &digDownConnectsAirShaft},
+		{"bulldozed Comm Tower stops covering", &bulldozedCommTowerStopsCovering},
+		{"dozed tile is passable again", &dozedTileIsPassableAgain},
+	};
+}
+
+
+int main(int argc, char *argv[])
+{
+	if (argc > 1)
+	{
+		std::cout << "Usage: " << argv[0] << std::endl;
+		return 1;
+	}
+
+	try
+	{
+		auto& filesystem = NAS2D::Utility<NAS2D::Filesystem>::init<NAS2D::Filesystem>(argv[0], "OutpostHD", "LairWorks");
+		filesystem.mountSoftFail("data");
+		filesystem.mountSoftFail(filesystem.basePath() + "data");
+
+		const auto planets = parsePlanetAttributes();
+		if (planets.empty())
+		{
+			throw std::runtime_error("No planets were found in the data files.");
+		}
+
+		int failures = 0;
+		for (const auto& check : Checks)
+		{
+			const auto passed = check.run(planets.front());
+			std::cout << (passed ? "PASS  " : "FAIL  ") << check.name << std::endl;
+			if (!passed) { ++failures; }
+		}
+
+		std::cout << std::endl << Checks.size() - static_cast<std::size_t>(failures) << " of " << Checks.size() << " checks passed" << std::endl;
+		return failures == 0 ? 0 : 1;
+	}
+	catch (const std::exception& e)
+	{
+		std::cout << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+}
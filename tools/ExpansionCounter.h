@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../OPHD/Map/TileMap.h"
+#include "../OPHD/MicroPather/micropather.h"
+
+#include <cstddef>
+#include <vector>
+
+
+/**
+ * Passes MicroPather's calls through to a TileMap, counting expanded
+ * tiles. Without a path cache MicroPather asks for the neighbours of
+ * each tile once, as it expands it.
+ */
+class ExpansionCounter : public micropather::Graph
+{
+public:
+	explicit ExpansionCounter(TileMap& tileMap) : mTileMap{tileMap} {}
+
+	float LeastCostEstimate(void* stateStart, void* stateEnd) override { return mTileMap.LeastCostEstimate(stateStart, stateEnd); }
+
+	void AdjacentCost(void* state, std::vector<micropather::StateCost>* adjacent) override
+	{
+		++mExpandedCount;
+		mTileMap.AdjacentCost(state, adjacent);
+	}
+
+	void PrintStateInfo(void* state) override { mTileMap.PrintStateInfo(state); }
+
+	std::size_t expandedCount() const { return mExpandedCount; }
+	void resetExpandedCount() { mExpandedCount = 0; }
+
+private:
+	TileMap& mTileMap;
+	std::size_t mExpandedCount{0};
+};
@@ -0,0 +1,149 @@
+// ==================================================================================
+// = Times building the TileMap of every shipped planet the way starting or loading a
+// = game does. Reports decoding the heightmap, reading terrain out of it and building
+// = the map with the heightmap not yet cached and with it cached, next to the cost of
+// = reading every pixel once per level, which is what TileMap construction used to do.
+// ==================================================================================
+
+#include "../OPHD/Cache.h"
+#include "../OPHD/Map/TileMap.h"
+#include "../OPHD/States/Planet.h"
+
+#include <NAS2D/Utility.h>
+#include <NAS2D/Filesystem.h>
+#include <NAS2D/Resource/Image.h>
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+
+namespace
+{
+	constexpr int DefaultRepeatCount = 10;
+	const std::string MapTerrainExtension = "_a.png";
+
+	using Clock = std::chrono::steady_clock;
+	using Milliseconds = std::chrono::duration<double, std::milli>;
+
+
+	void printUsage(const std::string& programName)
+	{
+		std::cout << "Usage: " << programName << " [repeats]" << std::endl << std::endl;
+		std::cout << "  repeats  Number of times each step is run. Defaults to " << DefaultRepeatCount << "." << std::endl;
+	}
+
+
+	int parseRepeatCount(const std::string& value)
+	{
+		const auto repeats = std::stoi(value);
+		if (repeats <= 0)
+		{
+			throw std::runtime_error("Repeat count must be greater than zero: " + value);
+		}
+		return repeats;
+	}
+
+
+	/**
+	 * Mean time of a step over repeatCount runs.
+	 */
+	template <typename Function>
+	double time(int repeatCount, Function function)
+	{
+		const auto start = Clock::now();
+		for (int repeat = 0; repeat < repeatCount; ++repeat)
+		{
+			function();
+		}
+		return Milliseconds{Clock::now() - start}.count() / repeatCount;
+	}
+
+
+	/**
+	 * Reads the red channel of every pixel passCount times, keeping a sum
+	 * so the reads can't be optimized away.
+	 */
+	std::size_t readPixels(const NAS2D::Image& heightmap, int passCount)
+	{
+		const auto size = heightmap.size();
+		std::size_t sum = 0;
+		for (int pass = 0; pass < passCount; ++pass)
+		{
+			for (int y = 0; y < size.y; ++y)
+			{
+				for (int x = 0; x < size.x; ++x)
+				{
+					sum += heightmap.pixelColor({x, y}).red / 50;
+				}
+			}
+		}
+		return sum;
+	}
+
+
+	void measure(const Planet::Attributes& attributes, int repeatCount)
+	{
+		const auto heightmapPath = attributes.mapImagePath + MapTerrainExtension;
+		const auto levelCount = attributes.maxDepth + 1;
+
+		const auto decodeTime = time(repeatCount, [&]() { NAS2D::Image{heightmapPath}; });
+
+		const NAS2D::Image heightmap{heightmapPath};
+		std::size_t checksum = 0;
+		const auto onceTime = time(repeatCount, [&]() { checksum += readPixels(heightmap, 1); });
+		const auto perLevelTime = time(repeatCount, [&]() { checksum += readPixels(heightmap, levelCount); });
+
+		const auto uncachedTime = time(repeatCount, [&]() {
+			imageCache.clear();
+			TileMap{attributes.mapImagePath, attributes.maxDepth};
+		});
+		const auto cachedTime = time(repeatCount, [&]() { TileMap{attributes.mapImagePath, attributes.maxDepth}; });
+
+		const auto size = heightmap.size();
+		std::cout << attributes.name << ": " << attributes.mapImagePath << ", " << size.x << "x" << size.y << ", depth " << attributes.maxDepth << " (checksum " << checksum << ")" << std::endl;
+		std::cout << "  decode heightmap               " << std::setw(10) << decodeTime << " ms" << std::endl;
+		std::cout << "  read pixels once               " << std::setw(10) << onceTime << " ms" << std::endl;
+		std::cout << "  read pixels once per level     " << std::setw(10) << perLevelTime << " ms" << std::endl;
+		std::cout << "  TileMap, heightmap not cached  " << std::setw(10) << uncachedTime << " ms" << std::endl;
+		std::cout << "  TileMap, heightmap cached      " << std::setw(10) << cachedTime << " ms" << std::endl;
+		std::cout << "  saved by reading once          " << std::setw(10) << perLevelTime - onceTime << " ms" << std::endl;
+		std::cout << "  saved by sharing the decode    " << std::setw(10) << uncachedTime - cachedTime << " ms" << std::endl;
+	}
+}
+
+
+int main(int argc, char *argv[])
+{
+	if (argc > 2)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	try
+	{
+		auto& filesystem = NAS2D::Utility<NAS2D::Filesystem>::init<NAS2D::Filesystem>(argv[0], "OutpostHD", "LairWorks");
+		filesystem.mountSoftFail("data");
+		filesystem.mountSoftFail(filesystem.basePath() + "data");
+
+		const int repeatCount = argc > 1 ? parseRepeatCount(argv[1]) : DefaultRepeatCount;
+
+		std::cout << std::fixed << std::setprecision(2);
+		for (const auto& attributes : parsePlanetAttributes())
+		{
+			measure(attributes, repeatCount);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cout << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,243 @@
+// ==================================================================================
+// = Builds TileMaps from the smallest shipped size up to the largest size a heightmap
+// = may have and reports what each costs: memory held by the map, time to build it,
+// = to bring every surface route cost up to date, to plan hauling routes the way
+// = OreLogisticsPlanner does, to dig out part of every underground level and to write
+// = the map out for a savegame. Last it writes terrain to every surface tile, which
+// = makes a Tile handle for each of them, to show the most the surface can cost. Maps
+// = are built in memory, so it needs no map images, data files or Renderer.
+// ==================================================================================
+
+#include "../OPHD/Common.h"
+#include "../OPHD/RandomNumberGenerator.h"
+#include "../OPHD/Constants/Numbers.h"
+#include "../OPHD/Map/DistanceField.h"
+#include "../OPHD/Map/TileMap.h"
+
+#include <NAS2D/Math/Point.h>
+#include <NAS2D/Math/Rectangle.h>
+#include <NAS2D/Math/Vector.h>
+#include <NAS2D/Xml/XmlElement.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	/**
+	 * Allocations carry their size in front of them so frees can be
+	 * subtracted. The header is as big as the strictest alignment new gives.
+	 */
+	constexpr std::size_t AllocationHeader = alignof(std::max_align_t);
+	std::atomic<std::size_t> liveBytes{0};
+}
+
+
+void* operator new(std::size_t size)
+{
+	if (auto* memory = static_cast<unsigned char*>(std::malloc(size + AllocationHeader)))
+	{
+		*reinterpret_cast<std::size_t*>(memory) = size;
+		liveBytes += size;
+		return memory + AllocationHeader;
+	}
+	throw std::bad_alloc{};
+}
+
+
+void operator delete(void* memory) noexcept
+{
+	if (!memory) { return; }
+	auto* allocation = static_cast<unsigned char*>(memory) - AllocationHeader;
+	liveBytes -= *reinterpret_cast<std::size_t*>(allocation);
+	std::free(allocation);
+}
+
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	operator delete(memory);
+}
+
+
+namespace
+{
+	constexpr std::uint64_t LayoutSeed = 1;
+	constexpr int MaxDepth = 4;
+	constexpr int TerrainPatchSize = 8;
+	constexpr int ObstaclePercent = 2;
+	constexpr int SmelterCount = 8;
+	constexpr int DigEdge = 64; /**< Edge of the square dug out of each underground level. */
+
+	const std::vector<NAS2D::Vector<int>> MapSizes =
+	{
+		{300, 150},
+		{1024, 1024},
+		{2048, 2048},
+		constants::MaximumMapSize,
+	};
+
+	using Clock = std::chrono::steady_clock;
+	using Milliseconds = std::chrono::duration<double, std::milli>;
+
+
+	template <typename Function>
+	double time(Function function)
+	{
+		const auto start = Clock::now();
+		function();
+		return Milliseconds{Clock::now() - start}.count();
+	}
+
+
+	double megabytes(std::size_t bytes)
+	{
+		return static_cast<double>(bytes) / (1024.0 * 1024.0);
+	}
+
+
+	/**
+	 * Clear, Rough and Difficult ground in square patches, like the bands
+	 * of a heightmap, with single Impassable tiles scattered over it.
+	 */
+	void buildTerrain(TileMap& tileMap, RandomNumberGenerator& random)
+	{
+		const auto size = tileMap.size();
+		const auto patchColumns = (size.x + TerrainPatchSize - 1) / TerrainPatchSize;
+		const auto patchRows = (size.y + TerrainPatchSize - 1) / TerrainPatchSize;
+		std::vector<TerrainType> patches;
+		for (int i = 0; i < patchColumns * patchRows; ++i)
+		{
+			patches.push_back(static_cast<TerrainType>(random.generate(static_cast<int>(TerrainType::Clear), static_cast<int>(TerrainType::Difficult))));
+		}
+
+		const auto surface = tileMap.tiles(NAS2D::Rectangle<int>::Create({0, 0}, size), 0);
+		for (int y = 0; y < size.y; ++y)
+		{
+			const auto row = surface.row(y);
+			for (int x = 0; x < size.x; ++x)
+			{
+				const auto blocked = random.generate(0, 99) < ObstaclePercent;
+				const auto patch = patches[static_cast<std::size_t>((y / TerrainPatchSize) * patchColumns + x / TerrainPatchSize)];
+				row[static_cast<std::size_t>(x)].index(blocked ? TerrainType::Impassable : patch);
+			}
+		}
+	}
+
+
+	/**
+	 * Hauling routes from smelters spread over the map, the fields
+	 * OreLogisticsPlanner builds when smelters come online.
+	 */
+	void planRoutes(TileMap& tileMap, RandomNumberGenerator& random)
+	{
+		const auto& routeCosts = tileMap.routeCosts();
+		const auto size = routeCosts.size();
+		const auto limit = RouteCostGrid::toCost(constants::ShortestPathTraversalCount);
+
+		DistanceField field;
+		for (int i = 0; i < SmelterCount; ++i)
+		{
+			const NAS2D::Point smelter{random.generate(0, size.x - 1), random.generate(0, size.y - 1)};
+			field.build(routeCosts, routeCosts.indexOf(smelter), limit);
+		}
+	}
+
+
+	void dig(TileMap& tileMap)
+	{
+		const auto size = tileMap.size();
+		const auto edge = std::min({DigEdge, size.x, size.y});
+		const NAS2D::Rectangle<int> area{(size.x - edge) / 2, (size.y - edge) / 2, edge, edge};
+		for (int depth = 1; depth <= tileMap.maxDepth(); ++depth)
+		{
+			for (const auto row : tileMap.tiles(area, depth))
+			{
+				for (auto& tile : row)
+				{
+					tile.excavated(true);
+				}
+			}
+		}
+	}
+
+
+	void check(NAS2D::Vector<int> mapSize)
+	{
+		RandomNumberGenerator random{LayoutSeed};
+		const auto bytesBefore = liveBytes.load();
+
+		std::unique_ptr<TileMap> tileMap;
+		const auto buildTime = time([&]() { tileMap = std::make_unique<TileMap>(mapSize, MaxDepth); });
+		const auto builtBytes = liveBytes.load() - bytesBefore;
+
+		const auto routeCostTime = time([&]() { tileMap->routeCosts(); });
+
+		tileMap->invalidateRouteCost(tileMap->getTile({{mapSize.x / 2, mapSize.y / 2}, 0}));
+		const auto routeCostChangeTime = time([&]() { tileMap->routeCosts(); });
+
+		const auto routeTime = time([&]() { planRoutes(*tileMap, random); });
+		const auto digTime = time([&]() { dig(*tileMap); });
+		const auto inUseBytes = liveBytes.load() - bytesBefore;
+
+		const auto serializeTime = time([&]() {
+			NAS2D::Xml::XmlElement element("map");
+			tileMap->serialize(&element);
+		});
+
+		const auto terrainTime = time([&]() { buildTerrain(*tileMap, random); });
+		const auto handleBytes = liveBytes.load() - bytesBefore;
+
+		const auto destroyTime = time([&]() { tileMap.reset(); });
+
+		std::cout << "Map " << mapSize.x << "x" << mapSize.y << ", depth " << MaxDepth << std::endl;
+		std::cout << "  memory when built       " << std::setw(10) << megabytes(builtBytes) << " MB" << std::endl;
+		std::cout << "  memory in use           " << std::setw(10) << megabytes(inUseBytes) << " MB" << std::endl;
+		std::cout << "  memory, every handle    " << std::setw(10) << megabytes(handleBytes) << " MB" << std::endl;
+		std::cout << "  build                   " << std::setw(10) << buildTime << " ms" << std::endl;
+		std::cout << "  all route costs         " << std::setw(10) << routeCostTime << " ms" << std::endl;
+		std::cout << "  one route cost          " << std::setw(10) << routeCostChangeTime << " ms" << std::endl;
+		std::cout << "  " << SmelterCount << " hauling fields       " << std::setw(10) << routeTime << " ms" << std::endl;
+		std::cout << "  dig " << DigEdge << "x" << DigEdge << " per level     " << std::setw(10) << digTime << " ms" << std::endl;
+		std::cout << "  serialize               " << std::setw(10) << serializeTime << " ms" << std::endl;
+		std::cout << "  write surface terrain   " << std::setw(10) << terrainTime << " ms" << std::endl;
+		std::cout << "  destroy                 " << std::setw(10) << destroyTime << " ms" << std::endl;
+	}
+}
+
+
+int main(int argc, char *argv[])
+{
+	if (argc > 1)
+	{
+		std::cout << "Usage: " << argv[0] << std::endl;
+		return 1;
+	}
+
+	try
+	{
+		std::cout << std::fixed << std::setprecision(1);
+		for (const auto mapSize : MapSizes)
+		{
+			check(mapSize);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cout << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
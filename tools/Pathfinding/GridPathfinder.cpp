@@ -0,0 +1,154 @@
+#include "GridPathfinder.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdlib>
+#include <stdexcept>
+
+
+GridPathfinder::GridPathfinder(const RouteCostGrid& routeCosts) :
+	mRouteCosts{routeCosts}
+{
+	const auto tileCount = static_cast<std::size_t>(mRouteCosts.tileCount());
+	mOpened.resize(tileCount, 0);
+	mClosed.resize(tileCount, 0);
+	mCostSoFar.resize(tileCount, 0);
+	mParent.resize(tileCount, 0);
+}
+
+
+/**
+ * Finds the cheapest surface path between two tiles.
+ *
+ * \return	Path listing the tiles from start to goal inclusive, or an
+ *			empty Path if the goal can't be reached.
+ */
+GridPathfinder::Path GridPathfinder::findPath(Index start, Index goal)
+{
+	const auto tileCount = mRouteCosts.tileCount();
+	if (start >= tileCount || goal >= tileCount)
+	{
+		throw std::runtime_error("GridPathfinder::findPath(): Tile index out of range");
+	}
+
+	mExpandedCount = 0;
+
+	Path path;
+	if (start == goal)
+	{
+		path.tiles.push_back(start);
+		return path;
+	}
+
+	if (mRouteCosts.endpointCost(goal) == RouteCostGrid::Impassable) { return path; }
+
+	nextSearch();
+
+	// Wide enough that f values still in the open list never share a bucket
+	const auto minCost = mRouteCosts.minCost() == RouteCostGrid::Impassable ? Cost{0} : mRouteCosts.minCost();
+	const auto bucketCount = std::bit_ceil(static_cast<std::size_t>(mRouteCosts.maxCost()) + minCost + 1);
+	if (mBuckets.size() < bucketCount) { mBuckets.resize(bucketCount); }
+	const auto bucketMask = mBuckets.size() - 1;
+
+	const auto goalPosition = mRouteCosts.positionOf(goal);
+	const auto width = static_cast<Index>(mRouteCosts.size().x);
+	std::size_t openCount = 0;
+
+	const auto open = [&](Index index, Cost costSoFar, Index parent)
+	{
+		mOpened[index] = mSearch;
+		mCostSoFar[index] = costSoFar;
+		mParent[index] = parent;
+		mBuckets[(costSoFar + heuristic(index, goalPosition)) & bucketMask].push_back(index);
+		++openCount;
+	};
+
+	open(start, 0, start);
+	auto f = static_cast<std::size_t>(heuristic(start, goalPosition));
+
+	while (openCount > 0)
+	{
+		auto& bucket = mBuckets[f & bucketMask];
+		if (bucket.empty())
+		{
+			++f;
+			continue;
+		}
+
+		const auto index = bucket.back();
+		bucket.pop_back();
+		--openCount;
+
+		// Tiles are pushed again when a cheaper way to them is found
+		if (mClosed[index] == mSearch) { continue; }
+		mClosed[index] = mSearch;
+		++mExpandedCount;
+
+		if (index == goal) { break; }
+
+		const auto visit = [&](Index neighbor)
+		{
+			if (mClosed[neighbor] == mSearch) { return; }
+
+			const auto moveCost = neighbor == goal ? mRouteCosts.endpointCost(neighbor) : mRouteCosts.passCost(neighbor);
+			if (moveCost == RouteCostGrid::Impassable) { return; }
+
+			const auto newCost = mCostSoFar[index] + moveCost;
+			if (mOpened[neighbor] == mSearch && newCost >= mCostSoFar[neighbor]) { return; }
+
+			open(neighbor, newCost, index);
+		};
+
+		const auto x = index % width;
+		if (x > 0) { visit(index - 1); }
+		if (x + 1 < width) { visit(index + 1); }
+		if (index >= width) { visit(index - width); }
+		if (index + width < tileCount) { visit(index + width); }
+	}
+
+	for (auto& openBucket : mBuckets)
+	{
+		openBucket.clear();
+	}
+
+	if (mClosed[goal] != mSearch) { return path; }
+
+	for (auto index = goal; index != start; index = mParent[index])
+	{
+		path.tiles.push_back(index);
+	}
+	path.tiles.push_back(start);
+	std::reverse(path.tiles.begin(), path.tiles.end());
+
+	path.cost = RouteCostGrid::toFloat(mCostSoFar[goal]);
+	return path;
+}
+
+
+void GridPathfinder::nextSearch()
+{
+	++mSearch;
+
+	// Stamps wrapped around so old ones could be mistaken for current ones
+	if (mSearch == 0)
+	{
+		std::fill(mOpened.begin(), mOpened.end(), 0);
+		std::fill(mClosed.begin(), mClosed.end(), 0);
+		mSearch = 1;
+	}
+}
+
+
+/**
+ * Manhattan distance to the goal at the cheapest cost of any tile. Never
+ * overestimates, so the first path found to the goal is the cheapest.
+ */
+GridPathfinder::Cost GridPathfinder::heuristic(Index index, NAS2D::Point<int> goal) const
+{
+	const auto minCost = mRouteCosts.minCost();
+	if (minCost == RouteCostGrid::Impassable) { return 0; }
+
+	const auto position = mRouteCosts.positionOf(index);
+	return static_cast<Cost>(std::abs(position.x - goal.x) + std::abs(position.y - goal.y)) * minCost;
+}
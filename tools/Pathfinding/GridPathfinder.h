@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../../OPHD/Map/RouteCostGrid.h"
+
+#include <NAS2D/Math/Point.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+/**
+ * A* over the surface of a TileMap, working directly on tile indices.
+ *
+ * Costs are read from a RouteCostGrid so a search never touches a Tile.
+ * Those are integers, so the open list can be a ring of buckets instead
+ * of a heap.
+ *
+ * Per-tile search state is stamped with the search that wrote it. Each
+ * search starts by bumping the stamp, so nothing needs to be cleared
+ * between searches.
+ *
+ * MicroPather over TileMap's Graph interface is kept as the reference
+ * implementation. Its distance estimate assumes every move costs at least
+ * 1.0, which roads undercut, so routes found here cost the same or less.
+ */
+class GridPathfinder
+{
+public:
+	using Index = RouteCostGrid::Index;
+	using Cost = RouteCostGrid::Cost;
+
+	struct Path
+	{
+		bool empty() const { return tiles.empty(); }
+
+		std::vector<Index> tiles;
+		float cost = 0.0f;
+	};
+
+public:
+	explicit GridPathfinder(const RouteCostGrid& routeCosts);
+
+	Path findPath(Index start, Index goal);
+
+	std::size_t expandedCount() const { return mExpandedCount; }
+
+private:
+	void nextSearch();
+
+	Cost heuristic(Index index, NAS2D::Point<int> goal) const;
+
+	const RouteCostGrid& mRouteCosts;
+
+	std::vector<std::uint32_t> mOpened;
+	std::vector<std::uint32_t> mClosed;
+	std::vector<Cost> mCostSoFar;
+	std::vector<Index> mParent;
+	std::uint32_t mSearch{0};
+
+	std::vector<std::vector<Index>> mBuckets;
+
+	std::size_t mExpandedCount{0};
+};
@@ -0,0 +1,533 @@
+#include "HierarchicalPathfinder.h"
+
+#include "../../OPHD/Map/TileMap.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+
+HierarchicalPathfinder::HierarchicalPathfinder(TileMap& tileMap) :
+	mTileMap{tileMap}
+{
+	const auto size = mTileMap.size();
+	mClusterCount = {(size.x + ClusterSize - 1) / ClusterSize, (size.y + ClusterSize - 1) / ClusterSize};
+
+	for (int y = 0; y < mClusterCount.y; ++y)
+	{
+		for (int x = 0; x < mClusterCount.x; ++x)
+		{
+			const NAS2D::Point origin{x * ClusterSize, y * ClusterSize};
+			const NAS2D::Vector clusterSize{std::min(ClusterSize, size.x - origin.x), std::min(ClusterSize, size.y - origin.y)};
+			mClusters.push_back({NAS2D::Rectangle<int>::Create(origin, clusterSize), {}, {}, {}, {}, true});
+		}
+	}
+}
+
+
+/**
+ * Marks every cluster to be rebuilt before the next query.
+ */
+void HierarchicalPathfinder::invalidate()
+{
+	for (auto& cluster : mClusters)
+	{
+		cluster.dirty = true;
+	}
+	mDirty = true;
+}
+
+
+/**
+ * Marks the clusters that depend on a tile to be rebuilt before the next
+ * query. A tile on a cluster's edge also dirties the cluster across that
+ * edge, since the entrances between them may have changed.
+ */
+void HierarchicalPathfinder::invalidate(NAS2D::Point<int> position)
+{
+	const NAS2D::Point cluster{position.x / ClusterSize, position.y / ClusterSize};
+	const NAS2D::Point offset{position.x % ClusterSize, position.y % ClusterSize};
+
+	const auto markDirty = [this](NAS2D::Point<int> clusterPosition)
+	{
+		if (!NAS2D::Rectangle{0, 0, mClusterCount.x, mClusterCount.y}.contains(clusterPosition)) { return; }
+		mClusters[static_cast<std::size_t>(clusterPosition.y * mClusterCount.x + clusterPosition.x)].dirty = true;
+	};
+
+	markDirty(cluster);
+	if (offset.x == 0) { markDirty({cluster.x - 1, cluster.y}); }
+	if (offset.x == ClusterSize - 1) { markDirty({cluster.x + 1, cluster.y}); }
+	if (offset.y == 0) { markDirty({cluster.x, cluster.y - 1}); }
+	if (offset.y == ClusterSize - 1) { markDirty({cluster.x, cluster.y + 1}); }
+
+	mDirty = true;
+}
+
+
+/**
+ * Finds a route from each start tile to whichever goal tile is cheapest to
+ * reach from it.
+ *
+ * Start and goal tiles are treated as route endpoints: trucks can drive
+ * onto them even if they hold a structure, but never through them.
+ *
+ * \return	One Path per start tile, in the same order. A Path is empty if
+ *			no goal can be reached from its start.
+ */
+std::vector<HierarchicalPathfinder::Path> HierarchicalPathfinder::findPathsToNearestGoal(const std::vector<Index>& starts, const std::vector<Index>& goals)
+{
+	std::vector<Path> paths(starts.size());
+	if (starts.empty() || goals.empty()) { return paths; }
+
+	update();
+
+	const auto baseNodeCount = static_cast<NodeId>(mNodeTiles.size());
+
+	// Starts and goals are added after the permanent nodes, once per tile
+	std::vector<Index> queryTiles;
+	std::unordered_map<Index, NodeId> goalIds;
+	std::unordered_map<Index, NodeId> startIds;
+	for (const auto goal : goals)
+	{
+		if (goalIds.try_emplace(goal, baseNodeCount + static_cast<NodeId>(queryTiles.size())).second)
+		{
+			queryTiles.push_back(goal);
+		}
+	}
+	for (const auto start : starts)
+	{
+		if (!goalIds.contains(start) && startIds.try_emplace(start, baseNodeCount + static_cast<NodeId>(queryTiles.size())).second)
+		{
+			queryTiles.push_back(start);
+		}
+	}
+
+	const auto nodeCount = static_cast<std::size_t>(baseNodeCount) + queryTiles.size();
+	const auto goalCount = goalIds.size();
+
+	std::vector<std::size_t> goalClusters;
+	for (std::size_t i = 0; i < goalCount; ++i)
+	{
+		goalClusters.push_back(clusterIndexOf(queryTiles[i]));
+	}
+
+	// Connect each goal to the nodes of its cluster, and each start to the
+	// nodes of its cluster and any goals sharing it
+	auto& search = mSearch;
+	std::unordered_map<NodeId, std::vector<Edge>> queryIncoming;
+	for (std::size_t i = 0; i < queryTiles.size(); ++i)
+	{
+		const auto tile = queryTiles[i];
+		const auto tileId = baseNodeCount + static_cast<NodeId>(i);
+		const auto clusterIndex = clusterIndexOf(tile);
+		const auto& cluster = mClusters[clusterIndex];
+
+		if (i < goalCount)
+		{
+			const Index endpoint[] = {tile};
+			for (const auto node : cluster.nodes)
+			{
+				searchCluster(search, node, cluster.area, endpoint, tile);
+				if (search.isSettled(tile))
+				{
+					queryIncoming[tileId].push_back({mNodeIds.at(node), search.costTo(tile)});
+				}
+			}
+			continue;
+		}
+
+		std::vector<Index> clusterGoals;
+		for (std::size_t goal = 0; goal < goalCount; ++goal)
+		{
+			if (goalClusters[goal] == clusterIndex) { clusterGoals.push_back(queryTiles[goal]); }
+		}
+
+		searchCluster(search, tile, cluster.area, clusterGoals);
+		for (const auto node : cluster.nodes)
+		{
+			if (search.isSettled(node))
+			{
+				queryIncoming[mNodeIds.at(node)].push_back({tileId, search.costTo(node)});
+			}
+		}
+		for (const auto goal : clusterGoals)
+		{
+			if (search.isSettled(goal))
+			{
+				queryIncoming[goalIds.at(goal)].push_back({tileId, search.costTo(goal)});
+			}
+		}
+	}
+
+	// Search backwards from every goal at once until every start is reached
+	std::vector<Cost> costToGoal(nodeCount, RouteCostGrid::Impassable);
+	std::vector<NodeId> nextNode(nodeCount, NoNode);
+	std::vector<bool> settled(nodeCount, false);
+	OpenList open;
+
+	for (const auto& [goal, goalId] : goalIds)
+	{
+		costToGoal[goalId] = 0;
+		open.push({0, goalId});
+	}
+
+	auto startsRemaining = startIds.size();
+	while (!open.empty() && startsRemaining > 0)
+	{
+		const auto [cost, node] = open.top();
+		open.pop();
+
+		if (settled[node]) { continue; }
+		settled[node] = true;
+
+		if (node >= baseNodeCount && !goalIds.contains(queryTiles[node - baseNodeCount]))
+		{
+			--startsRemaining;
+			continue;
+		}
+
+		const auto relax = [&](const Edge& edge)
+		{
+			const auto newCost = cost + edge.cost;
+			if (!settled[edge.node] && newCost < costToGoal[edge.node])
+			{
+				costToGoal[edge.node] = newCost;
+				nextNode[edge.node] = node;
+				open.push({newCost, edge.node});
+			}
+		};
+
+		if (node < baseNodeCount)
+		{
+			for (const auto& edge : mIncoming[node]) { relax(edge); }
+		}
+
+		const auto queryIt = queryIncoming.find(node);
+		if (queryIt != queryIncoming.end())
+		{
+			for (const auto& edge : queryIt->second) { relax(edge); }
+		}
+	}
+
+	const auto tileOf = [&](NodeId node) { return node < baseNodeCount ? mNodeTiles[node] : queryTiles[node - baseNodeCount]; };
+
+	// Refine each abstract route back into tiles
+	for (std::size_t i = 0; i < starts.size(); ++i)
+	{
+		const auto startIt = startIds.find(starts[i]);
+		if (startIt == startIds.end() || costToGoal[startIt->second] == RouteCostGrid::Impassable) { continue; }
+
+		auto& path = paths[i];
+		path.cost = RouteCostGrid::toFloat(costToGoal[startIt->second]);
+		path.tiles.push_back(starts[i]);
+
+		for (auto node = startIt->second; nextNode[node] != NoNode; node = nextNode[node])
+		{
+			const auto from = tileOf(node);
+			const auto to = tileOf(nextNode[node]);
+
+			// Steps across a cluster border are between neighbouring tiles
+			if (clusterIndexOf(from) != clusterIndexOf(to))
+			{
+				path.tiles.push_back(to);
+				continue;
+			}
+
+			appendClusterPath(search, path.tiles, from, to, nextNode[node] >= baseNodeCount);
+		}
+	}
+
+	return paths;
+}
+
+
+/**
+ * Rebuilds dirty clusters and the abstract graph.
+ */
+void HierarchicalPathfinder::update()
+{
+	// Always fetch so the cost grid catches up with invalidated tiles
+	mRouteCosts = &mTileMap.routeCosts();
+
+	if (!mDirty) { return; }
+
+	// A cluster's nodes include tiles from its neighbours' transitions so
+	// every transition has to be current before any nodes are rebuilt
+	for (auto& cluster : mClusters)
+	{
+		if (cluster.dirty) { updateTransitions(cluster); }
+	}
+
+	for (std::size_t i = 0; i < mClusters.size(); ++i)
+	{
+		if (mClusters[i].dirty) { updateNodes(i, mSearch); }
+	}
+
+	buildGraph();
+
+	for (auto& cluster : mClusters)
+	{
+		cluster.dirty = false;
+	}
+	mDirty = false;
+}
+
+
+/**
+ * Finds the entrances on a cluster's east and south borders.
+ */
+void HierarchicalPathfinder::updateTransitions(Cluster& cluster)
+{
+	const auto& routeCosts = *mRouteCosts;
+	const auto mapSize = routeCosts.size();
+	const auto passable = [&routeCosts](NAS2D::Point<int> position) { return routeCosts.passCost(routeCosts.indexOf(position)) != RouteCostGrid::Impassable; };
+
+	const auto scanBorder = [&](std::vector<Transition>& transitions, NAS2D::Point<int> first, NAS2D::Vector<int> step, int length, NAS2D::Vector<int> across)
+	{
+		transitions.clear();
+
+		const auto addTransition = [&](int offset)
+		{
+			const auto inside = first + step * offset;
+			transitions.push_back({routeCosts.indexOf(inside), routeCosts.indexOf(inside + across)});
+		};
+
+		int runStart = -1;
+		for (int offset = 0; offset <= length; ++offset)
+		{
+			const bool open = offset < length && passable(first + step * offset) && passable(first + step * offset + across);
+			if (open && runStart < 0)
+			{
+				runStart = offset;
+			}
+			else if (!open && runStart >= 0)
+			{
+				const auto runEnd = offset - 1;
+				if (runEnd - runStart + 1 >= WideEntrance)
+				{
+					addTransition(runStart);
+					addTransition(runEnd);
+				}
+				else
+				{
+					addTransition((runStart + runEnd) / 2);
+				}
+				runStart = -1;
+			}
+		}
+	};
+
+	const auto& area = cluster.area;
+	cluster.eastTransitions.clear();
+	cluster.southTransitions.clear();
+
+	if (area.x + area.width < mapSize.x)
+	{
+		scanBorder(cluster.eastTransitions, {area.x + area.width - 1, area.y}, {0, 1}, area.height, {1, 0});
+	}
+
+	if (area.y + area.height < mapSize.y)
+	{
+		scanBorder(cluster.southTransitions, {area.x, area.y + area.height - 1}, {1, 0}, area.width, {0, 1});
+	}
+}
+
+
+/**
+ * Collects a cluster's nodes from the transitions on all four of its
+ * borders and finds the cost between each pair of them.
+ */
+void HierarchicalPathfinder::updateNodes(std::size_t clusterIndex, ClusterSearch& search)
+{
+	auto& cluster = mClusters[clusterIndex];
+	const auto clusterX = static_cast<int>(clusterIndex) % mClusterCount.x;
+	const auto clusterY = static_cast<int>(clusterIndex) / mClusterCount.x;
+
+	auto& nodes = cluster.nodes;
+	nodes.clear();
+	for (const auto& [inside, outside] : cluster.eastTransitions) { nodes.push_back(inside); }
+	for (const auto& [inside, outside] : cluster.southTransitions) { nodes.push_back(inside); }
+	if (clusterX > 0)
+	{
+		for (const auto& [inside, outside] : mClusters[clusterIndex - 1].eastTransitions) { nodes.push_back(outside); }
+	}
+	if (clusterY > 0)
+	{
+		for (const auto& [inside, outside] : mClusters[clusterIndex - static_cast<std::size_t>(mClusterCount.x)].southTransitions) { nodes.push_back(outside); }
+	}
+
+	std::sort(nodes.begin(), nodes.end());
+	nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+	const auto nodeCount = nodes.size();
+	cluster.costs.assign(nodeCount * nodeCount, RouteCostGrid::Impassable);
+	for (std::size_t from = 0; from < nodeCount; ++from)
+	{
+		searchCluster(search, nodes[from], cluster.area, {});
+		for (std::size_t to = 0; to < nodeCount; ++to)
+		{
+			if (search.isSettled(nodes[to]))
+			{
+				cluster.costs[from * nodeCount + to] = search.costTo(nodes[to]);
+			}
+		}
+	}
+}
+
+
+/**
+ * Flattens every cluster's nodes and transitions into one graph.
+ */
+void HierarchicalPathfinder::buildGraph()
+{
+	mNodeTiles.clear();
+	mNodeIds.clear();
+
+	for (const auto& cluster : mClusters)
+	{
+		for (const auto node : cluster.nodes)
+		{
+			mNodeIds[node] = static_cast<NodeId>(mNodeTiles.size());
+			mNodeTiles.push_back(node);
+		}
+	}
+
+	mIncoming.assign(mNodeTiles.size(), {});
+
+	const auto& routeCosts = *mRouteCosts;
+	for (const auto& cluster : mClusters)
+	{
+		const auto& nodes = cluster.nodes;
+		const auto nodeCount = nodes.size();
+		for (std::size_t from = 0; from < nodeCount; ++from)
+		{
+			for (std::size_t to = 0; to < nodeCount; ++to)
+			{
+				const auto cost = cluster.costs[from * nodeCount + to];
+				if (from == to || cost == RouteCostGrid::Impassable) { continue; }
+				mIncoming[mNodeIds.at(nodes[to])].push_back({mNodeIds.at(nodes[from]), cost});
+			}
+		}
+
+		for (const auto& transitions : {std::cref(cluster.eastTransitions), std::cref(cluster.southTransitions)})
+		{
+			for (const auto& [inside, outside] : transitions.get())
+			{
+				const auto insideId = mNodeIds.at(inside);
+				const auto outsideId = mNodeIds.at(outside);
+				mIncoming[outsideId].push_back({insideId, routeCosts.passCost(outside)});
+				mIncoming[insideId].push_back({outsideId, routeCosts.passCost(inside)});
+			}
+		}
+	}
+}
+
+
+std::size_t HierarchicalPathfinder::clusterIndexOf(Index tile) const
+{
+	const auto position = mRouteCosts->positionOf(tile);
+	return static_cast<std::size_t>((position.y / ClusterSize) * mClusterCount.x + position.x / ClusterSize);
+}
+
+
+std::size_t HierarchicalPathfinder::ClusterSearch::slotOf(Index tile) const
+{
+	const auto x = static_cast<int>(tile % static_cast<Index>(mapWidth)) - area.x;
+	const auto y = static_cast<int>(tile / static_cast<Index>(mapWidth)) - area.y;
+	return static_cast<std::size_t>(y * ClusterSize + x);
+}
+
+
+/**
+ * Dijkstra search outward from a tile without leaving a cluster.
+ *
+ * Endpoint tiles can be driven onto at their endpoint cost but not
+ * through. Results are left in search for every tile it reports as
+ * settled. Stops early once target, if given, is settled.
+ */
+void HierarchicalPathfinder::searchCluster(ClusterSearch& search, Index from, const NAS2D::Rectangle<int>& area, std::span<const Index> endpoints, Index target) const
+{
+	++search.search;
+	if (search.search == 0)
+	{
+		search.reached.fill(0);
+		search.settled.fill(0);
+		search.search = 1;
+	}
+
+	const auto& routeCosts = *mRouteCosts;
+	const auto stamp = search.search;
+	search.area = area;
+	search.mapWidth = routeCosts.size().x;
+
+	auto& open = search.open;
+	open.clear();
+
+	const auto fromSlot = search.slotOf(from);
+	search.reached[fromSlot] = stamp;
+	search.cost[fromSlot] = 0;
+	search.parent[fromSlot] = from;
+	open.push_back({0, from});
+
+	while (!open.empty())
+	{
+		std::pop_heap(open.begin(), open.end(), std::greater<>{});
+		const auto [cost, index] = open.back();
+		open.pop_back();
+
+		const auto slot = search.slotOf(index);
+		if (search.settled[slot] == stamp) { continue; }
+		search.settled[slot] = stamp;
+
+		if (index == target) { break; }
+		if (index != from && std::find(endpoints.begin(), endpoints.end(), index) != endpoints.end()) { continue; }
+
+		const auto position = routeCosts.positionOf(index);
+		for (const auto offset : {NAS2D::Vector{0, -1}, NAS2D::Vector{1, 0}, NAS2D::Vector{0, 1}, NAS2D::Vector{-1, 0}})
+		{
+			const auto neighborPosition = position + offset;
+			if (!area.contains(neighborPosition)) { continue; }
+
+			const auto neighbor = routeCosts.indexOf(neighborPosition);
+			const auto neighborSlot = search.slotOf(neighbor);
+			if (search.settled[neighborSlot] == stamp) { continue; }
+
+			const bool isEndpoint = std::find(endpoints.begin(), endpoints.end(), neighbor) != endpoints.end();
+			const auto moveCost = isEndpoint ? routeCosts.endpointCost(neighbor) : routeCosts.passCost(neighbor);
+			if (moveCost == RouteCostGrid::Impassable) { continue; }
+
+			const auto newCost = cost + moveCost;
+			if (search.reached[neighborSlot] == stamp && newCost >= search.cost[neighborSlot]) { continue; }
+
+			search.reached[neighborSlot] = stamp;
+			search.cost[neighborSlot] = newCost;
+			search.parent[neighborSlot] = index;
+			open.push_back({newCost, neighbor});
+			std::push_heap(open.begin(), open.end(), std::greater<>{});
+		}
+	}
+}
+
+
+/**
+ * Appends the tiles after from up to and including to, following the
+ * cheapest path between them inside their cluster.
+ */
+void HierarchicalPathfinder::appendClusterPath(ClusterSearch& search, std::vector<Index>& path, Index from, Index to, bool toIsEndpoint) const
+{
+	if (from == to) { return; }
+
+	const Index endpoint[] = {to};
+	searchCluster(search, from, mClusters[clusterIndexOf(from)].area, toIsEndpoint ? std::span<const Index>{endpoint} : std::span<const Index>{}, to);
+	if (!search.isSettled(to))
+	{
+		throw std::runtime_error("HierarchicalPathfinder: Abstract route step could not be refined");
+	}
+
+	const auto insertAt = path.size();
+	for (auto index = to; index != from; index = search.parent[search.slotOf(index)])
+	{
+		path.push_back(index);
+	}
+	std::reverse(path.begin() + static_cast<std::ptrdiff_t>(insertAt), path.end());
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "GridPathfinder.h"
+
+#include "../../OPHD/Map/RouteCostGrid.h"
+
+#include <NAS2D/Math/Point.h>
+#include <NAS2D/Math/Rectangle.h>
+#include <NAS2D/Math/Vector.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+class TileMap;
+
+
+/**
+ * HPA* style pathfinding over the surface of a TileMap.
+ *
+ * The surface is cut into square clusters. Wherever tiles on both sides of
+ * a cluster border can be driven over there is an entrance, and the tiles
+ * either side of it become nodes of an abstract graph. Nodes in the same
+ * cluster are joined by the cost of the cheapest path between them that
+ * stays inside the cluster.
+ *
+ * A query adds its start and goal tiles to the graph, searches the graph,
+ * then refines each step back into tiles with a search confined to a
+ * single cluster. Routes can cost a little more than a search over every
+ * tile would find but the work no longer grows with the map area.
+ *
+ * A tile changing only dirties the cluster it's in, plus the neighbouring
+ * cluster if it's on a border. Dirty clusters are rebuilt before the next
+ * query.
+ *
+ * The game plans mine routes from a DistanceField per smelter instead.
+ * This is kept with the tools so PathfindingBenchmark can measure what
+ * clustering trades away.
+ */
+class HierarchicalPathfinder
+{
+public:
+	using Index = RouteCostGrid::Index;
+	using Cost = RouteCostGrid::Cost;
+	using Path = GridPathfinder::Path;
+
+	static constexpr int ClusterSize = 16;
+
+public:
+	explicit HierarchicalPathfinder(TileMap& tileMap);
+
+	HierarchicalPathfinder(const HierarchicalPathfinder&) = delete;
+	HierarchicalPathfinder& operator=(const HierarchicalPathfinder&) = delete;
+
+	void invalidate();
+	void invalidate(NAS2D::Point<int> position);
+
+	std::vector<Path> findPathsToNearestGoal(const std::vector<Index>& starts, const std::vector<Index>& goals);
+
+	std::size_t nodeCount() const { return mNodeTiles.size(); }
+
+private:
+	using NodeId = std::uint32_t;
+	using Transition = std::pair<Index, Index>; /**< Tile in this cluster and the tile across the border from it. */
+
+	using OpenList = std::priority_queue<std::pair<Cost, NodeId>, std::vector<std::pair<Cost, NodeId>>, std::greater<std::pair<Cost, NodeId>>>;
+
+	static constexpr Index NoTile = static_cast<Index>(-1);
+	static constexpr NodeId NoNode = static_cast<NodeId>(-1);
+
+	/**
+	 * Border openings at least this wide get an entrance at each end
+	 * instead of a single one in the middle.
+	 */
+	static constexpr int WideEntrance = 6;
+
+	struct Cluster
+	{
+		NAS2D::Rectangle<int> area;
+		std::vector<Transition> eastTransitions;
+		std::vector<Transition> southTransitions;
+		std::vector<Index> nodes;
+		std::vector<Cost> costs; /**< Cost from nodes[i] to nodes[j] at costs[i * nodes.size() + j]. */
+		bool dirty{true};
+	};
+
+	struct Edge
+	{
+		NodeId node;
+		Cost cost;
+	};
+
+	/**
+	 * State for a search confined to one cluster, indexed by tile position
+	 * within the cluster.
+	 */
+	struct ClusterSearch
+	{
+		static constexpr std::size_t SlotCount = static_cast<std::size_t>(ClusterSize * ClusterSize);
+
+		std::size_t slotOf(Index tile) const;
+		bool isSettled(Index tile) const { return settled[slotOf(tile)] == search; }
+		Cost costTo(Index tile) const { return cost[slotOf(tile)]; }
+
+		NAS2D::Rectangle<int> area;
+		int mapWidth{0};
+		std::array<std::uint32_t, SlotCount> reached{};
+		std::array<std::uint32_t, SlotCount> settled{};
+		std::array<Cost, SlotCount> cost{};
+		std::array<Index, SlotCount> parent{};
+		std::vector<std::pair<Cost, Index>> open; /**< Heap kept between searches to reuse its storage. */
+		std::uint32_t search{0};
+	};
+
+	void update();
+	void updateTransitions(Cluster& cluster);
+	void updateNodes(std::size_t clusterIndex, ClusterSearch& search);
+	void buildGraph();
+
+	std::size_t clusterIndexOf(Index tile) const;
+
+	void searchCluster(ClusterSearch& search, Index from, const NAS2D::Rectangle<int>& area, std::span<const Index> endpoints, Index target = NoTile) const;
+	void appendClusterPath(ClusterSearch& search, std::vector<Index>& path, Index from, Index to, bool toIsEndpoint) const;
+
+	TileMap& mTileMap;
+	const RouteCostGrid* mRouteCosts{nullptr};
+
+	NAS2D::Vector<int> mClusterCount;
+	std::vector<Cluster> mClusters;
+	bool mDirty{true};
+
+	std::vector<Index> mNodeTiles;
+	std::unordered_map<Index, NodeId> mNodeIds;
+	std::vector<std::vector<Edge>> mIncoming; /**< Edges into each node; queries search backwards from the goals. */
+
+	ClusterSearch mSearch;
+};
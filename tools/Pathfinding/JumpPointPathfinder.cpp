@@ -0,0 +1,353 @@
+#include "JumpPointPathfinder.h"
+
+#include <NAS2D/Math/Rectangle.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdlib>
+#include <stdexcept>
+
+
+namespace
+{
+	constexpr NAS2D::Vector<int> DirectionOffsets[] = {{0, -1}, {1, 0}, {0, 1}, {-1, 0}};
+	constexpr std::uint8_t Up = 0;
+	constexpr std::uint8_t Right = 1;
+	constexpr std::uint8_t Down = 2;
+	constexpr std::uint8_t Left = 3;
+	constexpr std::uint8_t NoDirection = 4;
+
+
+	std::uint8_t turned(std::uint8_t direction, int quarterTurns)
+	{
+		return static_cast<std::uint8_t>((direction + quarterTurns) % 4);
+	}
+
+
+	bool isVertical(std::uint8_t direction)
+	{
+		return direction == Up || direction == Down;
+	}
+}
+
+
+JumpPointPathfinder::JumpPointPathfinder(const RouteCostGrid& routeCosts) :
+	mRouteCosts{routeCosts}
+{
+	const auto tileCount = static_cast<std::size_t>(mRouteCosts.tileCount());
+	mOpened.resize(tileCount, 0);
+	mClosed.resize(tileCount, 0);
+	mCostSoFar.resize(tileCount, 0);
+	mParent.resize(tileCount, 0);
+	mDirection.resize(tileCount, NoDirection);
+}
+
+
+/**
+ * Finds the cheapest surface path between two tiles.
+ *
+ * \return	Path listing the tiles from start to goal inclusive, or an
+ *			empty Path if the goal can't be reached.
+ */
+JumpPointPathfinder::Path JumpPointPathfinder::findPath(Index start, Index goal)
+{
+	const auto tileCount = mRouteCosts.tileCount();
+	if (start >= tileCount || goal >= tileCount)
+	{
+		throw std::runtime_error("JumpPointPathfinder::findPath(): Tile index out of range");
+	}
+
+	mExpandedCount = 0;
+
+	Path path;
+	if (start == goal)
+	{
+		path.tiles.push_back(start);
+		return path;
+	}
+
+	if (mRouteCosts.endpointCost(goal) == RouteCostGrid::Impassable) { return path; }
+
+	if (mJumpDistance[0].empty() || mJumpDistanceRevision != mRouteCosts.revision())
+	{
+		buildJumpDistances();
+	}
+
+	nextSearch();
+	mGoal = goal;
+	mGoalPosition = mRouteCosts.positionOf(goal);
+
+	// Wide enough that f values still in the open list never share a bucket,
+	// with one jump crossing at most the whole map
+	const auto minCost = mRouteCosts.minCost() == RouteCostGrid::Impassable ? Cost{0} : mRouteCosts.minCost();
+	const auto longestJump = static_cast<std::size_t>(std::max(mRouteCosts.size().x, mRouteCosts.size().y));
+	const auto bucketCount = std::bit_ceil(longestJump * (static_cast<std::size_t>(mRouteCosts.maxCost()) + minCost) + 1);
+	if (mBuckets.size() < bucketCount) { mBuckets.resize(bucketCount); }
+	const auto bucketMask = mBuckets.size() - 1;
+
+	std::size_t openCount = 0;
+
+	const auto open = [&](Index index, Cost costSoFar, Index parent, std::uint8_t direction)
+	{
+		mOpened[index] = mSearch;
+		mCostSoFar[index] = costSoFar;
+		mParent[index] = parent;
+		mDirection[index] = direction;
+		mBuckets[(costSoFar + heuristic(index, mGoalPosition)) & bucketMask].push_back(index);
+		++openCount;
+	};
+
+	open(start, 0, start, NoDirection);
+	auto f = static_cast<std::size_t>(heuristic(start, mGoalPosition));
+
+	while (openCount > 0)
+	{
+		auto& bucket = mBuckets[f & bucketMask];
+		if (bucket.empty())
+		{
+			++f;
+			continue;
+		}
+
+		const auto index = bucket.back();
+		bucket.pop_back();
+		--openCount;
+
+		// Tiles are pushed again when a cheaper way to them is found
+		if (mClosed[index] == mSearch) { continue; }
+		mClosed[index] = mSearch;
+		++mExpandedCount;
+
+		if (index == goal) { break; }
+
+		const auto position = mRouteCosts.positionOf(index);
+		const auto arrivedIn = mDirection[index];
+		for (std::uint8_t direction = 0; direction < 4; ++direction)
+		{
+			// Everything behind was already covered by the jump that got here
+			if (arrivedIn != NoDirection && direction == turned(arrivedIn, 2)) { continue; }
+
+			const auto [tile, cost] = jump(position, direction);
+			if (tile == NoTile || mClosed[tile] == mSearch) { continue; }
+
+			const auto newCost = mCostSoFar[index] + cost;
+			if (mOpened[tile] == mSearch && newCost >= mCostSoFar[tile]) { continue; }
+
+			open(tile, newCost, index, direction);
+		}
+	}
+
+	for (auto& openBucket : mBuckets)
+	{
+		openBucket.clear();
+	}
+
+	mGoal = NoTile;
+
+	if (mClosed[goal] != mSearch) { return path; }
+
+	// Jump points are joined by straight lines; fill in the tiles between them
+	for (auto index = goal; index != start; index = mParent[index])
+	{
+		const auto to = mRouteCosts.positionOf(index);
+		const auto from = mRouteCosts.positionOf(mParent[index]);
+		const NAS2D::Vector step{(from.x > to.x) - (from.x < to.x), (from.y > to.y) - (from.y < to.y)};
+		for (auto position = to; position != from; position += step)
+		{
+			path.tiles.push_back(mRouteCosts.indexOf(position));
+		}
+	}
+	path.tiles.push_back(start);
+	std::reverse(path.tiles.begin(), path.tiles.end());
+
+	path.cost = RouteCostGrid::toFloat(mCostSoFar[goal]);
+	return path;
+}
+
+
+void JumpPointPathfinder::nextSearch()
+{
+	++mSearch;
+
+	// Stamps wrapped around so old ones could be mistaken for current ones
+	if (mSearch == 0)
+	{
+		std::fill(mOpened.begin(), mOpened.end(), 0);
+		std::fill(mClosed.begin(), mClosed.end(), 0);
+		mSearch = 1;
+	}
+}
+
+
+/**
+ * Works out how far a search runs from every tile in every direction.
+ *
+ * Each distance builds on the one from the next tile along, so rows and
+ * columns are swept from the far end. Vertical runs stop wherever a
+ * sideways run would stop somewhere, so horizontal distances come first.
+ */
+void JumpPointPathfinder::buildJumpDistances()
+{
+	const auto size = mRouteCosts.size();
+	for (auto& distances : mJumpDistance)
+	{
+		distances.assign(static_cast<std::size_t>(mRouteCosts.tileCount()), 0);
+	}
+
+	const NAS2D::Rectangle mapArea{0, 0, size.x, size.y};
+	const auto fill = [&](NAS2D::Point<int> position, std::uint8_t direction)
+	{
+		const auto next = position + DirectionOffsets[direction];
+		if (!mapArea.contains(next)) { return; }
+
+		const auto nextIndex = mRouteCosts.indexOf(next);
+		if (mRouteCosts.passCost(nextIndex) == RouteCostGrid::Impassable) { return; }
+
+		auto& distance = mJumpDistance[direction][mRouteCosts.indexOf(position)];
+		if (isStop(next, direction))
+		{
+			distance = 1;
+			return;
+		}
+
+		const auto nextDistance = mJumpDistance[direction][nextIndex];
+		distance = static_cast<std::int16_t>(nextDistance > 0 ? nextDistance + 1 : nextDistance - 1);
+	};
+
+	for (int y = 0; y < size.y; ++y)
+	{
+		for (int x = size.x - 1; x >= 0; --x) { fill({x, y}, Right); }
+		for (int x = 0; x < size.x; ++x) { fill({x, y}, Left); }
+	}
+
+	for (int x = 0; x < size.x; ++x)
+	{
+		for (int y = 0; y < size.y; ++y) { fill({x, y}, Up); }
+		for (int y = size.y - 1; y >= 0; --y) { fill({x, y}, Down); }
+	}
+
+	mJumpDistanceRevision = mRouteCosts.revision();
+}
+
+
+/**
+ * Whether a search moving in a direction has to stop at a tile.
+ *
+ * It does if the tile has a neighbour that costs something different, or
+ * a neighbour that can only be reached cheaply through it because the
+ * tile behind that neighbour is blocked. Moving up or down also stops
+ * where a sideways run would stop, so every tile a vertical run passes is
+ * covered.
+ */
+bool JumpPointPathfinder::isStop(NAS2D::Point<int> position, std::uint8_t direction) const
+{
+	const auto index = mRouteCosts.indexOf(position);
+	const auto uniformCost = mRouteCosts.passCost(index);
+	if (!isUniformAround(position, uniformCost)) { return true; }
+
+	const auto behind = position - DirectionOffsets[direction];
+	for (const auto side : {turned(direction, 1), turned(direction, 3)})
+	{
+		const auto sideOffset = DirectionOffsets[side];
+		if (isUniform(position + sideOffset, uniformCost) && !isUniform(behind + sideOffset, uniformCost))
+		{
+			return true;
+		}
+	}
+
+	if (isVertical(direction))
+	{
+		return mJumpDistance[Left][index] > 0 || mJumpDistance[Right][index] > 0;
+	}
+
+	return false;
+}
+
+
+/**
+ * Whether a tile is on the map and costs uniformCost to drive through.
+ */
+bool JumpPointPathfinder::isUniform(NAS2D::Point<int> position, Cost uniformCost) const
+{
+	if (!NAS2D::Rectangle{0, 0, mRouteCosts.size().x, mRouteCosts.size().y}.contains(position)) { return false; }
+	return mRouteCosts.passCost(mRouteCosts.indexOf(position)) == uniformCost;
+}
+
+
+/**
+ * Whether every neighbour of a tile either costs uniformCost or is
+ * blocked.
+ */
+bool JumpPointPathfinder::isUniformAround(NAS2D::Point<int> position, Cost uniformCost) const
+{
+	const NAS2D::Rectangle mapArea{0, 0, mRouteCosts.size().x, mRouteCosts.size().y};
+	for (const auto offset : DirectionOffsets)
+	{
+		const auto neighbor = position + offset;
+		if (!mapArea.contains(neighbor)) { continue; }
+
+		const auto cost = mRouteCosts.passCost(mRouteCosts.indexOf(neighbor));
+		if (cost != uniformCost && cost != RouteCostGrid::Impassable) { return false; }
+	}
+	return true;
+}
+
+
+/**
+ * Runs in a straight line from a tile to the next one the search has to
+ * stop at.
+ *
+ * Jump distances don't know about the goal, so this also stops on the
+ * goal and beside it. Vertical runs stop in the rows around the goal,
+ * where a sideways run could reach it.
+ *
+ * \return	The stopping point and the cost of getting there, or NoTile if
+ *			the line runs into an obstacle or off the map first.
+ */
+JumpPointPathfinder::Jump JumpPointPathfinder::jump(NAS2D::Point<int> from, std::uint8_t direction) const
+{
+	const auto offset = DirectionOffsets[direction];
+	const int distance = mJumpDistance[direction][mRouteCosts.indexOf(from)];
+	const auto passable = distance > 0 ? distance : -distance;
+
+	// Every tile run over costs the same as the first
+	const auto uniformCost = passable > 0 ? mRouteCosts.passCost(mRouteCosts.indexOf(from + offset)) : Cost{0};
+
+	const auto toGoal = mGoalPosition - from;
+	const auto ahead = toGoal.x * offset.x + toGoal.y * offset.y;
+	const auto across = isVertical(direction) ? toGoal.x : toGoal.y;
+
+	// Runs end just before an obstacle, which may be the goal itself
+	auto stop = distance > 0 ? distance : passable + 1;
+	if (across == 0 && ahead >= 1 && ahead <= stop)
+	{
+		return {mGoal, uniformCost * static_cast<Cost>(ahead - 1) + mRouteCosts.endpointCost(mGoal)};
+	}
+
+	if (isVertical(direction))
+	{
+		if (ahead >= 0) { stop = std::min(stop, std::max(ahead - 1, 1)); }
+	}
+	else if (std::abs(across) == 1 && ahead >= 1)
+	{
+		stop = std::min(stop, ahead);
+	}
+
+	if (stop > passable) { return {NoTile, 0}; }
+	return {mRouteCosts.indexOf(from + offset * stop), uniformCost * static_cast<Cost>(stop)};
+}
+
+
+/**
+ * Manhattan distance to the goal at the cheapest cost of any tile. Never
+ * overestimates, so the first path found to the goal is the cheapest.
+ */
+JumpPointPathfinder::Cost JumpPointPathfinder::heuristic(Index index, NAS2D::Point<int> goal) const
+{
+	const auto minCost = mRouteCosts.minCost();
+	if (minCost == RouteCostGrid::Impassable) { return 0; }
+
+	const auto position = mRouteCosts.positionOf(index);
+	return static_cast<Cost>(std::abs(position.x - goal.x) + std::abs(position.y - goal.y)) * minCost;
+}
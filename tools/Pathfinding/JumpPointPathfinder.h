@@ -0,0 +1,92 @@
+#pragma once
+
+#include "GridPathfinder.h"
+
+#include "../../OPHD/Map/RouteCostGrid.h"
+
+#include <NAS2D/Math/Point.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+/**
+ * Jump point search over the surface of a TileMap.
+ *
+ * Most of the surface is open terrain that all costs the same to cross,
+ * where A* wastes most of its time on the many equally cheap ways around
+ * the same tiles. Here a search runs in straight lines across such areas
+ * instead of expanding each tile. It only stops at tiles where something
+ * changes: an obstacle opening up beside it, the goal, or a tile or
+ * neighbour that costs something different, like a road or rough ground.
+ * Each of those stopping points is expanded in every direction, which
+ * makes the search the same as GridPathfinder around roads and mixed
+ * terrain.
+ *
+ * How far a search can run from each tile in each direction doesn't depend
+ * on the goal, so it's worked out for the whole map up front and again
+ * whenever the RouteCostGrid changes. Searches then only have to check
+ * whether the goal is along the way.
+ *
+ * Paths cost the same as GridPathfinder's.
+ */
+class JumpPointPathfinder
+{
+public:
+	using Index = RouteCostGrid::Index;
+	using Cost = RouteCostGrid::Cost;
+	using Path = GridPathfinder::Path;
+
+public:
+	explicit JumpPointPathfinder(const RouteCostGrid& routeCosts);
+
+	Path findPath(Index start, Index goal);
+
+	std::size_t expandedCount() const { return mExpandedCount; }
+
+private:
+	static constexpr Index NoTile = static_cast<Index>(-1);
+
+	struct Jump
+	{
+		Index tile;
+		Cost cost;
+	};
+
+	void nextSearch();
+
+	void buildJumpDistances();
+	bool isStop(NAS2D::Point<int> position, std::uint8_t direction) const;
+	bool isUniform(NAS2D::Point<int> position, Cost uniformCost) const;
+	bool isUniformAround(NAS2D::Point<int> position, Cost uniformCost) const;
+
+	Jump jump(NAS2D::Point<int> from, std::uint8_t direction) const;
+
+	Cost heuristic(Index index, NAS2D::Point<int> goal) const;
+
+	const RouteCostGrid& mRouteCosts;
+
+	/**
+	 * Per direction, how far a search runs from each tile. A positive value
+	 * is the distance to the tile it stops at. Otherwise it runs into an
+	 * obstacle or the edge of the map after passing -value tiles.
+	 */
+	std::array<std::vector<std::int16_t>, 4> mJumpDistance;
+	std::uint32_t mJumpDistanceRevision{0};
+
+	Index mGoal{NoTile};
+	NAS2D::Point<int> mGoalPosition;
+
+	std::vector<std::uint32_t> mOpened;
+	std::vector<std::uint32_t> mClosed;
+	std::vector<Cost> mCostSoFar;
+	std::vector<Index> mParent;
+	std::vector<std::uint8_t> mDirection; /**< Direction a tile was reached in, as an index into the direction offsets. */
+	std::uint32_t mSearch{0};
+
+	std::vector<std::vector<Index>> mBuckets;
+
+	std::size_t mExpandedCount{0};
+};
@@ -0,0 +1,255 @@
+// ==================================================================================
+// = Compares GridPathfinder, JumpPointPathfinder and HierarchicalPathfinder against
+// = MicroPather on a site map. All of them solve the same set of randomly chosen
+// = surface routes. Reports the time each takes and how many tiles the exact ones
+// = expand, checks that GridPathfinder never finds a more expensive route than the
+// = reference, that JumpPointPathfinder's routes cost the same as GridPathfinder's
+// = and how much HierarchicalPathfinder gives up. Also times every start routed to
+// = its nearest goal in one query.
+// ==================================================================================
+
+#include "ExpansionCounter.h"
+#include "Pathfinding/GridPathfinder.h"
+#include "Pathfinding/HierarchicalPathfinder.h"
+#include "Pathfinding/JumpPointPathfinder.h"
+
+#include "../OPHD/RandomNumberGenerator.h"
+#include "../OPHD/Map/TileMap.h"
+#include "../OPHD/MicroPather/micropather.h"
+
+#include <NAS2D/Utility.h>
+#include <NAS2D/Filesystem.h>
+
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+	constexpr int DefaultRouteCount = 1000;
+	constexpr std::uint64_t RouteSeed = 1;
+	constexpr float CostTolerance = 0.001f;
+	constexpr std::size_t MultiStartGoalCount = 8;
+
+	using Clock = std::chrono::steady_clock;
+	using Milliseconds = std::chrono::duration<double, std::milli>;
+
+
+	void printUsage(const std::string& programName)
+	{
+		std::cout << "Usage: " << programName << " <map> [routes]" << std::endl << std::endl;
+		std::cout << "  map     Site map image path without extension, e.g. maps/mercury_01." << std::endl;
+		std::cout << "  routes  Number of routes to solve. Defaults to " << DefaultRouteCount << "." << std::endl;
+	}
+
+
+	int parseRouteCount(const std::string& value)
+	{
+		const auto routes = std::stoi(value);
+		if (routes <= 0)
+		{
+			throw std::runtime_error("Route count must be greater than zero: " + value);
+		}
+		return routes;
+	}
+
+
+	NAS2D::Point<int> randomPassablePosition(const TileMap& tileMap, RandomNumberGenerator& random)
+	{
+		const auto size = tileMap.size();
+		while (true)
+		{
+			const NAS2D::Point position{random.generate(0, size.x - 1), random.generate(0, size.y - 1)};
+			if (tileMap.routeCost(tileMap.getTile({position, 0}), true) != FLT_MAX)
+			{
+				return position;
+			}
+		}
+	}
+}
+
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	try
+	{
+		auto& filesystem = NAS2D::Utility<NAS2D::Filesystem>::init<NAS2D::Filesystem>(argv[0], "OutpostHD", "LairWorks");
+		filesystem.mountSoftFail("data");
+		filesystem.mountSoftFail(filesystem.basePath() + "data");
+
+		const int routeCount = argc > 2 ? parseRouteCount(argv[2]) : DefaultRouteCount;
+
+		TileMap tileMap(argv[1], 0);
+		const auto size = tileMap.size();
+		std::cout << "Map '" << argv[1] << "' " << size.x << "x" << size.y << ", " << routeCount << " routes" << std::endl << std::endl;
+
+		RandomNumberGenerator random{RouteSeed};
+		std::vector<std::pair<NAS2D::Point<int>, NAS2D::Point<int>>> endpoints;
+		for (int i = 0; i < routeCount; ++i)
+		{
+			const auto start = randomPassablePosition(tileMap, random);
+			const auto goal = randomPassablePosition(tileMap, random);
+			endpoints.push_back({start, goal});
+		}
+
+		// Same configuration the game used: no path cache
+		ExpansionCounter expansionCounter{tileMap};
+		micropather::MicroPather microPather(&expansionCounter, 250, 6, false);
+		std::vector<float> referenceCosts;
+		std::vector<void*> referencePath;
+
+		const auto referenceStart = Clock::now();
+		for (const auto& [start, goal] : endpoints)
+		{
+			auto* startTile = &tileMap.getTile({start, 0});
+			auto* goalTile = &tileMap.getTile({goal, 0});
+			tileMap.pathStartAndEnd(startTile, goalTile);
+
+			float cost = 0.0f;
+			const auto result = microPather.Solve(startTile, goalTile, &referencePath, &cost);
+			referenceCosts.push_back(result == micropather::MicroPather::NO_SOLUTION ? FLT_MAX : cost);
+		}
+		const auto referenceTime = Milliseconds{Clock::now() - referenceStart}.count();
+
+		// Time building the grid from scratch; the TileMap's own grid was already built by MicroPather
+		const auto setupStart = Clock::now();
+		RouteCostGrid routeCosts{size};
+		routeCosts.update(tileMap);
+		const auto setupTime = Milliseconds{Clock::now() - setupStart}.count();
+
+		GridPathfinder gridPathfinder{routeCosts};
+
+		std::vector<float> gridCosts;
+		std::size_t gridExpandedCount = 0;
+		const auto gridStart = Clock::now();
+		for (const auto& [start, goal] : endpoints)
+		{
+			const auto path = gridPathfinder.findPath(routeCosts.indexOf(start), routeCosts.indexOf(goal));
+			gridCosts.push_back(path.empty() ? FLT_MAX : path.cost);
+			gridExpandedCount += gridPathfinder.expandedCount();
+		}
+		const auto gridTime = Milliseconds{Clock::now() - gridStart}.count();
+
+		JumpPointPathfinder jumpPointPathfinder{routeCosts};
+		const auto jumpPointSetupStart = Clock::now();
+		jumpPointPathfinder.findPath(0, 1);
+		const auto jumpPointSetupTime = Milliseconds{Clock::now() - jumpPointSetupStart}.count();
+
+		std::vector<float> jumpPointCosts;
+		std::size_t jumpPointExpandedCount = 0;
+		const auto jumpPointStart = Clock::now();
+		for (const auto& [start, goal] : endpoints)
+		{
+			const auto path = jumpPointPathfinder.findPath(routeCosts.indexOf(start), routeCosts.indexOf(goal));
+			jumpPointCosts.push_back(path.empty() ? FLT_MAX : path.cost);
+			jumpPointExpandedCount += jumpPointPathfinder.expandedCount();
+		}
+		const auto jumpPointTime = Milliseconds{Clock::now() - jumpPointStart}.count();
+
+		HierarchicalPathfinder hierarchicalPathfinder{tileMap};
+		const auto hierarchySetupStart = Clock::now();
+		hierarchicalPathfinder.findPathsToNearestGoal({0}, {0});
+		const auto hierarchySetupTime = Milliseconds{Clock::now() - hierarchySetupStart}.count();
+
+		std::vector<float> hierarchyCosts;
+		const auto hierarchyStart = Clock::now();
+		for (const auto& [start, goal] : endpoints)
+		{
+			const auto paths = hierarchicalPathfinder.findPathsToNearestGoal({routeCosts.indexOf(start)}, {routeCosts.indexOf(goal)});
+			hierarchyCosts.push_back(paths.front().empty() ? FLT_MAX : paths.front().cost);
+		}
+		const auto hierarchyTime = Milliseconds{Clock::now() - hierarchyStart}.count();
+
+		int cheaperCount = 0;
+		int mismatchCount = 0;
+		int hierarchyRouteCount = 0;
+		double hierarchyCostRatio = 0.0;
+		for (std::size_t i = 0; i < endpoints.size(); ++i)
+		{
+			const auto reference = referenceCosts[i];
+			const auto grid = gridCosts[i];
+			const auto hierarchy = hierarchyCosts[i];
+			const auto jumpPoint = jumpPointCosts[i];
+
+			if ((grid == FLT_MAX) != (jumpPoint == FLT_MAX) || std::abs(grid - jumpPoint) > CostTolerance)
+			{
+				const auto& [start, goal] = endpoints[i];
+				std::cout << "Jump point mismatch (" << start.x << ", " << start.y << ") -> (" << goal.x << ", " << goal.y << "): ";
+				std::cout << "GridPathfinder " << grid << ", JumpPointPathfinder " << jumpPoint << std::endl;
+				++mismatchCount;
+			}
+
+			if ((grid == FLT_MAX) != (hierarchy == FLT_MAX))
+			{
+				const auto& [start, goal] = endpoints[i];
+				std::cout << "Reachability mismatch (" << start.x << ", " << start.y << ") -> (" << goal.x << ", " << goal.y << "): ";
+				std::cout << "GridPathfinder " << grid << ", HierarchicalPathfinder " << hierarchy << std::endl;
+				++mismatchCount;
+			}
+			else if (grid != FLT_MAX && grid > 0.0f)
+			{
+				hierarchyCostRatio += static_cast<double>(hierarchy) / static_cast<double>(grid);
+				++hierarchyRouteCount;
+			}
+
+			if ((reference == FLT_MAX) != (grid == FLT_MAX) || (grid != FLT_MAX && grid > reference + CostTolerance))
+			{
+				const auto& [start, goal] = endpoints[i];
+				std::cout << "Mismatch (" << start.x << ", " << start.y << ") -> (" << goal.x << ", " << goal.y << "): ";
+				std::cout << "MicroPather " << reference << ", GridPathfinder " << grid << std::endl;
+				++mismatchCount;
+			}
+			else if (grid != FLT_MAX && grid < reference - CostTolerance)
+			{
+				++cheaperCount;
+			}
+		}
+
+		std::cout << "MicroPather:     " << referenceTime << " ms, " << referenceTime / routeCount << " ms/route" << std::endl;
+		std::cout << "GridPathfinder:  " << gridTime << " ms, " << gridTime / routeCount << " ms/route (+" << setupTime << " ms cost grid)" << std::endl;
+		std::cout << "Speedup:         " << referenceTime / gridTime << "x" << std::endl;
+		std::cout << "JumpPoint:       " << jumpPointTime << " ms, " << jumpPointTime / routeCount << " ms/route (+" << jumpPointSetupTime << " ms jump distances)" << std::endl;
+		std::cout << "Expanded/route:  MicroPather " << expansionCounter.expandedCount() / routeCount;
+		std::cout << ", GridPathfinder " << gridExpandedCount / routeCount;
+		std::cout << ", JumpPoint " << jumpPointExpandedCount / routeCount << std::endl;
+		std::cout << "Hierarchical:    " << hierarchyTime << " ms, " << hierarchyTime / routeCount << " ms/route (+" << hierarchySetupTime << " ms graph, ";
+		std::cout << hierarchicalPathfinder.nodeCount() << " nodes)" << std::endl;
+		std::cout << "Hierarchical mean cost vs GridPathfinder: " << (hierarchyRouteCount > 0 ? hierarchyCostRatio / hierarchyRouteCount : 1.0) << std::endl;
+
+		// Same work the colony does each turn: every mine to its nearest smelter in one query
+		std::vector<HierarchicalPathfinder::Index> starts;
+		std::vector<HierarchicalPathfinder::Index> goals;
+		for (const auto& [start, goal] : endpoints)
+		{
+			starts.push_back(routeCosts.indexOf(start));
+			if (goals.size() < MultiStartGoalCount) { goals.push_back(routeCosts.indexOf(goal)); }
+		}
+
+		const auto nearestStart = Clock::now();
+		hierarchicalPathfinder.findPathsToNearestGoal(starts, goals);
+		const auto nearestTime = Milliseconds{Clock::now() - nearestStart}.count();
+
+		std::cout << "Nearest of " << goals.size() << " goals: " << nearestTime << " ms for " << starts.size() << " starts" << std::endl << std::endl;
+		std::cout << "Cheaper routes:  " << cheaperCount << std::endl;
+		std::cout << "Mismatches:      " << mismatchCount << std::endl;
+
+		return mismatchCount == 0 ? 0 : 1;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,581 @@
+// ==================================================================================
+// = Pathfinding benchmark and regression check on synthetic maps. Builds each
+// = scenario's terrain in memory, so it needs no map images, data files or
+// = Renderer. Times MicroPather::Solve from every mine to every smelter,
+// = MicroPather::SolveForNearStates from every smelter and the route planning
+// = ColonySimulation::findMineRoutes does, then compares tiles expanded,
+// = allocations and nanoseconds per solve against a committed baseline.
+// =
+// = Facilities and roads are Structures, which can't be created without their
+// = sprites, so their tiles are bulldozed ground instead. Operational roads
+// = cost the same to drive over. Mine routes are planned with a DistanceField
+// = per smelter, the same work OreLogisticsPlanner does for findMineRoutes.
+// = Those fields are also rebuilt on a WorkerPool, as OreLogisticsPlanner rebuilds
+// = them, and must come out the same as fields built one at a time.
+// ==================================================================================
+
+#include "ExpansionCounter.h"
+
+#include "../OPHD/Common.h"
+#include "../OPHD/RandomNumberGenerator.h"
+#include "../OPHD/WorkerPool.h"
+#include "../OPHD/Constants/Numbers.h"
+#include "../OPHD/Map/DistanceField.h"
+#include "../OPHD/Map/TileMap.h"
+#include "../OPHD/MicroPather/micropather.h"
+#include "../OPHD/States/Route.h"
+
+#include <NAS2D/Math/Point.h>
+#include <NAS2D/Math/Rectangle.h>
+#include <NAS2D/Math/Vector.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+	std::atomic<std::size_t> allocationCount{0};
+}
+
+
+void* operator new(std::size_t size)
+{
+	++allocationCount;
+	if (auto* memory = std::malloc(size == 0 ? 1 : size)) { return memory; }
+	throw std::bad_alloc{};
+}
+
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+
+namespace
+{
+	constexpr std::uint64_t LayoutSeed = 1;
+	constexpr int TerrainPatchSize = 8;
+	constexpr double DefaultTolerance = 0.1;
+	constexpr double DefaultTimeTolerance = 0.5;
+	constexpr double ResultTolerance = 0.001;
+	constexpr std::size_t MinimumWorkerCount = 4; /**< Fields are shared out even on a machine with fewer cores. */
+	const std::string DefaultBaselinePath = "tools/PathfindingRegressionBaseline.txt";
+
+	using Clock = std::chrono::steady_clock;
+	using Nanoseconds = std::chrono::duration<double, std::nano>;
+
+
+	/**
+	 * Map and colony layout to measure.
+	 *
+	 * Terrain is Clear, Rough or Difficult in square patches, like the bands
+	 * of a heightmap, with single Impassable tiles scattered over it. Mines
+	 * are placed around the smelters so most of them are in hauling range.
+	 */
+	struct Scenario
+	{
+		std::string name;
+		NAS2D::Vector<int> mapSize;
+		int obstaclePercent;
+		int smelterCount;
+		int mineCount;
+		int mineSpread; /**< Furthest a mine is placed from its smelter, in tiles along each axis. */
+		int roadSpacing; /**< Tiles between roads in a grid over the whole map, or 0 for none. */
+	};
+
+	const std::vector<Scenario> Scenarios =
+	{
+		{"small-open", {150, 75}, 2, 2, 8, 30, 0},
+		{"site-open", {300, 150}, 2, 3, 16, 40, 0},
+		{"site-dense", {300, 150}, 20, 3, 16, 40, 0},
+		{"site-roads", {300, 150}, 5, 3, 16, 40, 10},
+		{"large-open", {600, 300}, 2, 4, 32, 40, 0},
+		{"large-dense", {600, 300}, 20, 4, 32, 40, 0},
+	};
+
+
+	struct Layout
+	{
+		std::vector<NAS2D::Point<int>> smelters;
+		std::vector<NAS2D::Point<int>> mines;
+	};
+
+
+	/**
+	 * Per solve averages for one solver on one scenario. Result is a
+	 * checksum of what the solver found, like the total cost of its routes,
+	 * which shouldn't change unless the solver's behaviour does.
+	 */
+	struct Measurement
+	{
+		double expanded = 0.0;
+		double allocations = 0.0;
+		double nanoseconds = 0.0;
+		double result = 0.0;
+	};
+
+	using Measurements = std::map<std::string, Measurement>;
+
+
+	struct Options
+	{
+		std::string baselinePath = DefaultBaselinePath;
+		bool writeBaseline = false;
+		double tolerance = DefaultTolerance;
+		double timeTolerance = DefaultTimeTolerance;
+	};
+
+
+	void printUsage(const std::string& programName)
+	{
+		std::cout << "Usage: " << programName << " [options]" << std::endl << std::endl;
+		std::cout << "  --baseline <file>          Baseline to compare against. Defaults to " << DefaultBaselinePath << "." << std::endl;
+		std::cout << "  --write-baseline           Write the results to the baseline file instead of comparing." << std::endl;
+		std::cout << "  --tolerance <fraction>     Allowed drift in tiles expanded and allocations. Defaults to " << DefaultTolerance << "." << std::endl;
+		std::cout << "  --time-tolerance <fraction>  Allowed slowdown per solve. Defaults to " << DefaultTimeTolerance << "." << std::endl;
+	}
+
+
+	double parseFraction(const std::string& value)
+	{
+		const auto fraction = std::stod(value);
+		if (fraction < 0.0)
+		{
+			throw std::runtime_error("Tolerance can't be negative: " + value);
+		}
+		return fraction;
+	}
+
+
+	Options parseOptions(int argc, char *argv[])
+	{
+		Options options;
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string argument = argv[i];
+			const auto value = [&]() -> std::string
+			{
+				if (i + 1 >= argc) { throw std::runtime_error("Missing value for " + argument); }
+				return argv[++i];
+			};
+
+			if (argument == "--baseline") { options.baselinePath = value(); }
+			else if (argument == "--write-baseline") { options.writeBaseline = true; }
+			else if (argument == "--tolerance") { options.tolerance = parseFraction(value()); }
+			else if (argument == "--time-tolerance") { options.timeTolerance = parseFraction(value()); }
+			else { throw std::runtime_error("Unknown option: " + argument); }
+		}
+		return options;
+	}
+
+
+	NAS2D::Point<int> randomPosition(NAS2D::Vector<int> mapSize, RandomNumberGenerator& random)
+	{
+		return {random.generate(0, mapSize.x - 1), random.generate(0, mapSize.y - 1)};
+	}
+
+
+	Layout buildTerrain(TileMap& tileMap, const Scenario& scenario)
+	{
+		RandomNumberGenerator random{LayoutSeed};
+		const auto size = tileMap.size();
+
+		const auto patchColumns = (size.x + TerrainPatchSize - 1) / TerrainPatchSize;
+		const auto patchRows = (size.y + TerrainPatchSize - 1) / TerrainPatchSize;
+		std::vector<TerrainType> patches;
+		for (int i = 0; i < patchColumns * patchRows; ++i)
+		{
+			patches.push_back(static_cast<TerrainType>(random.generate(static_cast<int>(TerrainType::Clear), static_cast<int>(TerrainType::Difficult))));
+		}
+
+		for (int y = 0; y < size.y; ++y)
+		{
+			for (int x = 0; x < size.x; ++x)
+			{
+				const auto onRoad = scenario.roadSpacing > 0 && (x % scenario.roadSpacing == 0 || y % scenario.roadSpacing == 0);
+				const auto patch = patches[static_cast<std::size_t>((y / TerrainPatchSize) * patchColumns + x / TerrainPatchSize)];
+				const auto blocked = random.generate(0, 99) < scenario.obstaclePercent;
+				tileMap.getTile({{x, y}, 0}).index(onRoad ? TerrainType::Dozed : blocked ? TerrainType::Impassable : patch);
+			}
+		}
+
+		const NAS2D::Rectangle<int> mapArea{0, 0, size.x, size.y};
+		const auto placeFacility = [&tileMap](NAS2D::Point<int> position)
+		{
+			tileMap.getTile({position, 0}).index(TerrainType::Dozed);
+			return position;
+		};
+
+		Layout layout;
+		for (int i = 0; i < scenario.smelterCount; ++i)
+		{
+			layout.smelters.push_back(placeFacility(randomPosition(size, random)));
+		}
+
+		while (static_cast<int>(layout.mines.size()) < scenario.mineCount)
+		{
+			const auto& smelter = layout.smelters[layout.mines.size() % layout.smelters.size()];
+			const NAS2D::Vector offset{random.generate(-scenario.mineSpread, scenario.mineSpread), random.generate(-scenario.mineSpread, scenario.mineSpread)};
+			const auto position = smelter + offset;
+			if (!mapArea.contains(position) || position == smelter) { continue; }
+			layout.mines.push_back(placeFacility(position));
+		}
+
+		return layout;
+	}
+
+
+	Measurement measureSolve(TileMap& tileMap, const Layout& layout)
+	{
+		ExpansionCounter expansionCounter{tileMap};
+		micropather::MicroPather microPather(&expansionCounter, 250, 6, false);
+		std::vector<void*> path;
+
+		std::size_t solveCount = 0;
+		double totalCost = 0.0;
+
+		const auto allocationsBefore = allocationCount.load();
+		const auto start = Clock::now();
+		for (const auto& minePosition : layout.mines)
+		{
+			auto* mineTile = &tileMap.getTile({minePosition, 0});
+
+			float cheapest = FLT_MAX;
+			for (const auto& smelterPosition : layout.smelters)
+			{
+				auto* smelterTile = &tileMap.getTile({smelterPosition, 0});
+				tileMap.pathStartAndEnd(mineTile, smelterTile);
+
+				float cost = 0.0f;
+				if (microPather.Solve(mineTile, smelterTile, &path, &cost) == micropather::MicroPather::SOLVED)
+				{
+					cheapest = std::min(cheapest, cost);
+				}
+				++solveCount;
+			}
+
+			if (cheapest != FLT_MAX) { totalCost += static_cast<double>(cheapest); }
+		}
+		const auto time = Nanoseconds{Clock::now() - start}.count();
+
+		const auto solves = static_cast<double>(solveCount);
+		return {
+			static_cast<double>(expansionCounter.expandedCount()) / solves,
+			static_cast<double>(allocationCount.load() - allocationsBefore) / solves,
+			time / solves,
+			totalCost
+		};
+	}
+
+
+	Measurement measureSolveForNearStates(TileMap& tileMap, const Layout& layout)
+	{
+		ExpansionCounter expansionCounter{tileMap};
+		micropather::MicroPather microPather(&expansionCounter, 250, 6, false);
+		std::vector<micropather::StateCost> near;
+
+		std::size_t nearCount = 0;
+
+		const auto allocationsBefore = allocationCount.load();
+		const auto start = Clock::now();
+		for (const auto& smelterPosition : layout.smelters)
+		{
+			auto* smelterTile = &tileMap.getTile({smelterPosition, 0});
+			tileMap.pathStartAndEnd(smelterTile, nullptr);
+
+			microPather.SolveForNearStates(smelterTile, &near, constants::ShortestPathTraversalCount);
+			nearCount += near.size();
+		}
+		const auto time = Nanoseconds{Clock::now() - start}.count();
+
+		const auto solves = static_cast<double>(layout.smelters.size());
+		return {
+			static_cast<double>(expansionCounter.expandedCount()) / solves,
+			static_cast<double>(allocationCount.load() - allocationsBefore) / solves,
+			time / solves,
+			static_cast<double>(nearCount)
+		};
+	}
+
+
+	Measurement measureMineRoutes(TileMap& tileMap, const Layout& layout)
+	{
+		const auto& routeCosts = tileMap.routeCosts();
+		const auto mapWidth = routeCosts.size().x;
+		const auto limit = RouteCostGrid::toCost(constants::ShortestPathTraversalCount);
+
+		std::vector<DistanceField> fields(layout.smelters.size());
+		std::vector<Route> routes;
+
+		const auto allocationsBefore = allocationCount.load();
+		const auto start = Clock::now();
+		for (std::size_t i = 0; i < fields.size(); ++i)
+		{
+			fields[i].build(routeCosts, routeCosts.indexOf(layout.smelters[i]), limit);
+		}
+
+		for (const auto& minePosition : layout.mines)
+		{
+			const auto mineTile = routeCosts.indexOf(minePosition);
+
+			const DistanceField* cheapestField = nullptr;
+			auto cheapest = RouteCostGrid::Impassable;
+			for (const auto& field : fields)
+			{
+				const auto cost = field.cost(mineTile);
+				if (cost < cheapest)
+				{
+					cheapest = cost;
+					cheapestField = &field;
+				}
+			}
+
+			if (!cheapestField) { continue; }
+			routes.push_back(Route::fromTiles(cheapestField->path(routeCosts, mineTile), mapWidth, RouteCostGrid::toFloat(cheapest)));
+		}
+		const auto time = Nanoseconds{Clock::now() - start}.count();
+		const auto allocations = allocationCount.load() - allocationsBefore;
+
+		// Tiles each field reached, counted after timing
+		std::size_t reachedCount = 0;
+		for (const auto& field : fields)
+		{
+			for (RouteCostGrid::Index tile = 0; tile < routeCosts.tileCount(); ++tile)
+			{
+				if (field.cost(tile) != RouteCostGrid::Impassable) { ++reachedCount; }
+			}
+		}
+
+		double totalCost = 0.0;
+		for (const auto& route : routes)
+		{
+			totalCost += static_cast<double>(route.cost);
+		}
+
+		const auto solves = static_cast<double>(layout.mines.size());
+		return {
+			static_cast<double>(reachedCount) / solves,
+			static_cast<double>(allocations) / solves,
+			time / solves,
+			totalCost
+		};
+	}
+
+
+	/**
+	 * Builds every smelter's field on its own and again side by side on a
+	 * WorkerPool, the way OreLogisticsPlanner::update rebuilds them, and
+	 * counts the tiles whose cost differs between the two.
+	 */
+	std::size_t countWorkerPoolMismatches(TileMap& tileMap, const Layout& layout, WorkerPool& workers)
+	{
+		const auto& routeCosts = tileMap.routeCosts();
+		const auto limit = RouteCostGrid::toCost(constants::ShortestPathTraversalCount);
+
+		std::vector<DistanceField> serialFields(layout.smelters.size());
+		for (std::size_t i = 0; i < serialFields.size(); ++i)
+		{
+			serialFields[i].build(routeCosts, routeCosts.indexOf(layout.smelters[i]), limit);
+		}
+
+		std::vector<DistanceField> pooledFields(layout.smelters.size());
+		workers.forEach(pooledFields.size(), [&](std::size_t, std::size_t i)
+		{
+			pooledFields[i].build(routeCosts, routeCosts.indexOf(layout.smelters[i]), limit);
+		});
+
+		std::size_t mismatchCount = 0;
+		for (std::size_t i = 0; i < serialFields.size(); ++i)
+		{
+			for (RouteCostGrid::Index tile = 0; tile < routeCosts.tileCount(); ++tile)
+			{
+				if (serialFields[i].cost(tile) != pooledFields[i].cost(tile)) { ++mismatchCount; }
+			}
+		}
+		return mismatchCount;
+	}
+
+
+	Measurements readBaseline(const std::string& path)
+	{
+		std::ifstream file(path);
+		if (!file)
+		{
+			throw std::runtime_error("Baseline '" + path + "' could not be opened. Create it with --write-baseline.");
+		}
+
+		Measurements baseline;
+		std::string line;
+		while (std::getline(file, line))
+		{
+			if (line.empty() || line.front() == '#') { continue; }
+
+			std::istringstream fields(line);
+			std::string key;
+			Measurement measurement;
+			if (!(fields >> key >> measurement.expanded >> measurement.allocations >> measurement.nanoseconds >> measurement.result))
+			{
+				throw std::runtime_error("Malformed baseline line: " + line);
+			}
+			baseline[key] = measurement;
+		}
+		return baseline;
+	}
+
+
+	void writeBaseline(const std::string& path, const Measurements& measurements)
+	{
+		std::ofstream file(path);
+		if (!file)
+		{
+			throw std::runtime_error("Baseline '" + path + "' could not be written.");
+		}
+
+		file << "# Written by PathfindingRegression --write-baseline. Times depend on the machine and build" << std::endl;
+		file << "# configuration, so regenerate this when comparing on a different one." << std::endl;
+		file << "# scenario/solver expanded/solve allocations/solve ns/solve result" << std::endl;
+		file << std::fixed << std::setprecision(3);
+		for (const auto& [key, measurement] : measurements)
+		{
+			file << key << " " << measurement.expanded << " " << measurement.allocations << " " << measurement.nanoseconds << " " << measurement.result << std::endl;
+		}
+	}
+
+
+	double drift(double value, double baseline)
+	{
+		if (baseline == 0.0) { return value == 0.0 ? 0.0 : 1.0; }
+		return (value - baseline) / baseline;
+	}
+
+
+	/**
+	 * Compares one measurement to its baseline, printing anything out of
+	 * tolerance. Time and allocations only fail for going up.
+	 */
+	bool withinTolerance(const std::string& key, const Measurement& measurement, const Measurement& baseline, const Options& options)
+	{
+		bool passed = true;
+		const auto check = [&](const std::string& name, double value, double expected, double tolerance, bool bothWays)
+		{
+			const auto change = drift(value, expected);
+			if (change > tolerance || (bothWays && -change > tolerance))
+			{
+				std::cout << "  " << key << " " << name << " drifted " << std::showpos << change * 100.0 << std::noshowpos << "%: ";
+				std::cout << value << " against baseline " << expected << std::endl;
+				passed = false;
+			}
+		};
+
+		check("result", measurement.result, baseline.result, ResultTolerance, true);
+		check("expanded/solve", measurement.expanded, baseline.expanded, options.tolerance, true);
+		check("allocations/solve", measurement.allocations, baseline.allocations, options.tolerance, false);
+		check("ns/solve", measurement.nanoseconds, baseline.nanoseconds, options.timeTolerance, false);
+		return passed;
+	}
+}
+
+
+int main(int argc, char *argv[])
+{
+	try
+	{
+		const auto options = parseOptions(argc, argv);
+		std::cout << std::fixed << std::setprecision(1);
+
+		WorkerPool workers{std::max(WorkerPool::defaultWorkerCount(), MinimumWorkerCount)};
+		std::size_t workerPoolMismatchCount = 0;
+
+		Measurements measurements;
+		for (const auto& scenario : Scenarios)
+		{
+			TileMap tileMap(scenario.mapSize, 0);
+			const auto layout = buildTerrain(tileMap, scenario);
+			tileMap.routeCosts();
+
+			std::cout << scenario.name << ": " << scenario.mapSize.x << "x" << scenario.mapSize.y << ", " << scenario.obstaclePercent << "% obstacles, ";
+			std::cout << layout.mines.size() << " mines, " << layout.smelters.size() << " smelters";
+			if (scenario.roadSpacing > 0) { std::cout << ", roads every " << scenario.roadSpacing << " tiles"; }
+			std::cout << std::endl;
+
+			const std::pair<std::string, Measurement> results[] =
+			{
+				{"Solve", measureSolve(tileMap, layout)},
+				{"SolveForNearStates", measureSolveForNearStates(tileMap, layout)},
+				{"findMineRoutes", measureMineRoutes(tileMap, layout)},
+			};
+
+			for (const auto& [solver, measurement] : results)
+			{
+				std::cout << "  " << std::left << std::setw(20) << solver << std::right;
+				std::cout << std::setw(10) << measurement.expanded << " expanded" << std::setw(10) << measurement.allocations << " allocations";
+				std::cout << std::setw(14) << measurement.nanoseconds << " ns per solve" << std::endl;
+				measurements[scenario.name + "/" + solver] = measurement;
+			}
+
+			const auto mismatchCount = countWorkerPoolMismatches(tileMap, layout, workers);
+			std::cout << "  Fields on " << workers.workerCount() << " workers: ";
+			std::cout << (mismatchCount == 0 ? "same as built one at a time" : std::to_string(mismatchCount) + " tiles differ") << std::endl;
+			workerPoolMismatchCount += mismatchCount;
+		}
+		std::cout << std::endl;
+
+		if (workerPoolMismatchCount > 0)
+		{
+			std::cout << "Fields rebuilt on a WorkerPool differ from fields built one at a time" << std::endl;
+			return 1;
+		}
+
+		if (options.writeBaseline)
+		{
+			writeBaseline(options.baselinePath, measurements);
+			std::cout << "Wrote baseline '" << options.baselinePath << "'" << std::endl;
+			return 0;
+		}
+
+		const auto baseline = readBaseline(options.baselinePath);
+		int failureCount = 0;
+		for (const auto& [key, measurement] : measurements)
+		{
+			const auto expected = baseline.find(key);
+			if (expected == baseline.end())
+			{
+				std::cout << "  " << key << " has no baseline" << std::endl;
+				continue;
+			}
+
+			if (!withinTolerance(key, measurement, expected->second, options)) { ++failureCount; }
+		}
+
+		std::cout << (failureCount == 0 ? "All within tolerance of " : std::to_string(failureCount) + " drifted from ") << options.baselinePath << std::endl;
+		return failureCount == 0 ? 0 : 1;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		printUsage(argv[0]);
+		return 1;
+	}
+}
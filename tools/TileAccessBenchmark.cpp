@@ -0,0 +1,153 @@
+// ==================================================================================
+// = Measures the cost of visiting tiles through TileMap::getTile(), which checks
+// = every position it's given, against visiting the same tiles through the rows of
+// = a TileMap::tiles() area, which is checked once. Walks a view sized rectangle
+// = the way DetailMap does each frame and every level of the whole map the way a
+// = full map pass does, and reports the time per tile of both.
+// ==================================================================================
+
+#include "../OPHD/Map/TileMap.h"
+
+#include <NAS2D/Math/PointInRectangleRange.h>
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+
+namespace
+{
+	constexpr int DefaultRepeatCount = 200;
+	const auto MapSize = NAS2D::Vector{300, 150};
+	constexpr int MaxDepth = 4;
+	constexpr int ViewEdge = 40;
+
+	using Clock = std::chrono::steady_clock;
+	using Nanoseconds = std::chrono::duration<double, std::nano>;
+
+
+	void printUsage(const std::string& programName)
+	{
+		std::cout << "Usage: " << programName << " [repeats]" << std::endl << std::endl;
+		std::cout << "  repeats  Number of times each pass is run. Defaults to " << DefaultRepeatCount << "." << std::endl;
+	}
+
+
+	int parseRepeatCount(const std::string& value)
+	{
+		const auto repeats = std::stoi(value);
+		if (repeats <= 0)
+		{
+			throw std::runtime_error("Repeat count must be greater than zero: " + value);
+		}
+		return repeats;
+	}
+
+
+	/**
+	 * Reads what DetailMap reads from each tile, so neither pass can be
+	 * optimized away.
+	 */
+	std::size_t visit(const Tile& tile)
+	{
+		return static_cast<std::size_t>(tile.excavated()) + static_cast<std::size_t>(tile.index()) + (tile.thing() != nullptr);
+	}
+
+
+	struct Result
+	{
+		double checkedTime;
+		double spanTime;
+		std::size_t tileCount;
+	};
+
+
+	Result measure(TileMap& tileMap, const NAS2D::Rectangle<int>& area, int firstDepth, int lastDepth, int repeatCount)
+	{
+		std::size_t checkedSum = 0;
+		const auto checkedStart = Clock::now();
+		for (int repeat = 0; repeat < repeatCount; ++repeat)
+		{
+			for (int depth = firstDepth; depth <= lastDepth; ++depth)
+			{
+				for (const auto point : NAS2D::PointInRectangleRange{area})
+				{
+					checkedSum += visit(tileMap.getTile({point, depth}));
+				}
+			}
+		}
+		const auto checkedTime = Nanoseconds{Clock::now() - checkedStart}.count();
+
+		std::size_t spanSum = 0;
+		const auto spanStart = Clock::now();
+		for (int repeat = 0; repeat < repeatCount; ++repeat)
+		{
+			for (int depth = firstDepth; depth <= lastDepth; ++depth)
+			{
+				for (const auto row : tileMap.tiles(area, depth))
+				{
+					for (const auto& tile : row)
+					{
+						spanSum += visit(tile);
+					}
+				}
+			}
+		}
+		const auto spanTime = Nanoseconds{Clock::now() - spanStart}.count();
+
+		if (checkedSum != spanSum)
+		{
+			throw std::runtime_error("Checked and span passes visited different tiles");
+		}
+
+		const auto tileCount = static_cast<std::size_t>(area.width) * static_cast<std::size_t>(area.height) * static_cast<std::size_t>(lastDepth - firstDepth + 1) * static_cast<std::size_t>(repeatCount);
+		return {checkedTime, spanTime, tileCount};
+	}
+
+
+	void printResult(const std::string& name, const Result& result)
+	{
+		const auto checkedPerTile = result.checkedTime / static_cast<double>(result.tileCount);
+		const auto spanPerTile = result.spanTime / static_cast<double>(result.tileCount);
+
+		std::cout << name << std::endl;
+		std::cout << "  getTile()  " << std::setw(8) << checkedPerTile << " ns per tile" << std::endl;
+		std::cout << "  tiles()    " << std::setw(8) << spanPerTile << " ns per tile" << std::endl;
+		std::cout << "  removed    " << std::setw(8) << checkedPerTile - spanPerTile << " ns per tile" << std::endl;
+	}
+}
+
+
+int main(int argc, char *argv[])
+{
+	if (argc > 2)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	try
+	{
+		const int repeatCount = argc > 1 ? parseRepeatCount(argv[1]) : DefaultRepeatCount;
+
+		TileMap tileMap(MapSize, MaxDepth);
+		std::cout << std::fixed << std::setprecision(2);
+		std::cout << "Map " << MapSize.x << "x" << MapSize.y << ", depth " << MaxDepth << ", " << repeatCount << " repeats" << std::endl << std::endl;
+
+		const NAS2D::Rectangle<int> viewArea{(MapSize.x - ViewEdge) / 2, (MapSize.y - ViewEdge) / 2, ViewEdge, ViewEdge};
+		printResult("View " + std::to_string(ViewEdge) + "x" + std::to_string(ViewEdge) + " on the surface", measure(tileMap, viewArea, 0, 0, repeatCount * 100));
+
+		const auto mapArea = NAS2D::Rectangle<int>::Create({0, 0}, MapSize);
+		printResult("Whole map, every level", measure(tileMap, mapArea, 0, MaxDepth, repeatCount));
+	}
+	catch (const std::exception& e)
+	{
+		std::cout << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
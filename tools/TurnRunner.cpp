@@ -0,0 +1,130 @@
+// ==================================================================================
+// = Command line turn runner. Loads a savegame into a ColonySimulation and advances
+// = it a fixed number of turns without ever opening a window or creating a Renderer.
+// = Used to measure turn processing cost in isolation from drawing and UI.
+// ==================================================================================
+
+#include "../OPHD/Common.h"
+#include "../OPHD/Constants/Strings.h"
+#include "../OPHD/States/ColonySimulation.h"
+
+#include <NAS2D/Utility.h>
+#include <NAS2D/Filesystem.h>
+#include <NAS2D/Xml/XmlDocument.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+	constexpr int DefaultTurnCount = 100;
+
+	using Clock = std::chrono::steady_clock;
+	using Milliseconds = std::chrono::duration<double, std::milli>;
+
+
+	void printUsage(const std::string& programName)
+	{
+		std::cout << "Usage: " << programName << " <savegame> [turns]" << std::endl << std::endl;
+		std::cout << "  savegame  Name of a savegame in the user's savegame folder, without extension." << std::endl;
+		std::cout << "  turns     Number of turns to simulate. Defaults to " << DefaultTurnCount << "." << std::endl;
+	}
+
+
+	int parseTurnCount(const std::string& value)
+	{
+		const auto turns = std::stoi(value);
+		if (turns <= 0)
+		{
+			throw std::runtime_error("Turn count must be greater than zero: " + value);
+		}
+		return turns;
+	}
+}
+
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2)
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	try
+	{
+		auto& filesystem = NAS2D::Utility<NAS2D::Filesystem>::init<NAS2D::Filesystem>(argv[0], "OutpostHD", "LairWorks");
+		filesystem.mountSoftFail("data");
+		filesystem.mountSoftFail(filesystem.basePath() + "data");
+		filesystem.mountReadWrite(filesystem.prefPath());
+
+		const std::string filename = constants::SaveGamePath + argv[1] + ".xml";
+		if (!filesystem.exists(filename))
+		{
+			throw std::runtime_error("Savegame '" + filename + "' was not found.");
+		}
+
+		const int turns = argc > 2 ? parseTurnCount(argv[2]) : DefaultTurnCount;
+
+		const auto loadStart = Clock::now();
+		auto xmlDocument = openSavegame(filename);
+		ColonySimulation colonySimulation;
+		colonySimulation.load(xmlDocument.firstChildElement(constants::SaveGameRootNode));
+		const auto loadTime = Milliseconds{Clock::now() - loadStart};
+
+		std::cout << "Loaded '" << filename << "' at turn " << colonySimulation.turnCount();
+		std::cout << " in " << loadTime.count() << " ms" << std::endl;
+		std::cout << "Random seed " << colonySimulation.randomSeed() << std::endl << std::endl;
+
+		std::vector<double> turnTimes;
+		turnTimes.reserve(static_cast<std::size_t>(turns));
+
+		const auto runStart = Clock::now();
+		for (int i = 0; i < turns; ++i)
+		{
+			const auto turnStart = Clock::now();
+			colonySimulation.nextTurn();
+			turnTimes.push_back(Milliseconds{Clock::now() - turnStart}.count());
+
+			std::cout << "Turn " << colonySimulation.turnCount() << ": " << turnTimes.back() << " ms" << std::endl;
+		}
+		const auto totalTime = Milliseconds{Clock::now() - runStart}.count();
+
+		const auto [minTime, maxTime] = std::minmax_element(turnTimes.begin(), turnTimes.end());
+		const auto meanTime = std::accumulate(turnTimes.begin(), turnTimes.end(), 0.0) / static_cast<double>(turnTimes.size());
+
+		std::cout << std::endl;
+		std::cout << "Turns:      " << turns << std::endl;
+		std::cout << "Total:      " << totalTime << " ms" << std::endl;
+		std::cout << "Turns/sec:  " << (static_cast<double>(turns) * 1000.0 / totalTime) << std::endl;
+		std::cout << "Per turn:   min " << *minTime << " ms, max " << *maxTime << " ms, mean " << meanTime << " ms" << std::endl;
+
+		const auto& history = colonySimulation.turnProfiler().history();
+		std::cout << std::endl << "Phase means over the last " << history.size() << " turns:" << std::endl;
+		for (const auto& phase : history.back().phases)
+		{
+			double sum = 0.0;
+			for (const auto& turnRecord : history)
+			{
+				for (const auto& recordedPhase : turnRecord.phases)
+				{
+					if (recordedPhase.name == phase.name) { sum += recordedPhase.milliseconds; }
+				}
+			}
+			std::cout << "  " << phase.name << ": " << sum / static_cast<double>(history.size()) << " ms" << std::endl;
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}